@@ -17,9 +17,10 @@
   must implement has a TODO block comment. 
 */
 
+#include <algorithm>
 #include <stdexcept>
-#include <regex>
 #include <sstream>
+#include <utility>
 
 #include "area.h"
 #include "bethyw.h"
@@ -35,7 +36,26 @@
   @example
     Area("W06000023");
 */
-Area::Area(const std::string& localAuthorityCode) : localAuthorityCode(localAuthorityCode) {
+Area::Area(const std::string& localAuthorityCode) : Area(localAuthorityCode, nullptr) {
+}
+
+/*
+  Area::Area(localAuthorityCode, arena)
+
+  Construct an Area whose names and Measures are allocated from an Arena,
+  see arena.h. Areas passes its Arena to each Area created by upsertArea().
+
+  @param localAuthorityCode
+    The local authority code of the Area
+
+  @param arena
+    The Arena to allocate from, or nullptr to use the heap
+*/
+Area::Area(const std::string& localAuthorityCode, std::shared_ptr<BethYw::Arena> arena)
+	: localAuthorityCode(BethYw::intern(localAuthorityCode)),
+	names(std::less<std::string>(), BethYw::ArenaAllocator<std::pair<const std::string, BethYw::Symbol>>(arena)),
+	measures(BethYw::SymbolHandleOrder(), BethYw::ArenaAllocator<std::pair<const BethYw::Symbol, Measure>>(arena)),
+	measureOrder(BethYw::ArenaAllocator<BethYw::Symbol>(arena)) {
 }
 
 /*
@@ -52,8 +72,8 @@ Area::Area(const std::string& localAuthorityCode) : localAuthorityCode(localAuth
     ...
     auto authCode = area.getLocalAuthorityCode();
 */
-const std::string Area::getLocalAuthorityCode() const {
-	return localAuthorityCode;
+const std::string& Area::getLocalAuthorityCode() const {
+	return localAuthorityCode.str();
 }
 
 /*
@@ -80,12 +100,25 @@ const std::string Area::getLocalAuthorityCode() const {
     ...
     auto name = area.getName(langCode);
 */
-const std::string Area::getName(const std::string lang) const {
+const std::string& Area::getName(const std::string lang) const {
+	const std::string* name = findName(lang);
+	if (name == nullptr) {
+		throw std::out_of_range("No name found for language " + lang);
+	}
+	return *name;
+}
+
+/*
+	findName(lang)
+	Returns a pointer to the name for a language, or nullptr if there is none.
+	Unlike getName(), this does not throw if there is no name.
+*/
+const std::string* Area::findName(const std::string& lang) const noexcept {
 	auto it = names.find(lang);
 	if (it == names.end()) {
-		throw std::out_of_range("No name found for language " + lang);
+		return nullptr;
 	}
-	return it->second;
+	return &it->second.str();
 }
 
 /*
@@ -113,14 +146,35 @@ const std::string Area::getName(const std::string lang) const {
     std::string langValueWelsh = "Powys";
     area.setName(langCodeWelsh, langValueWelsh);
 */
-void Area::setName(std::string lang, const std::string name) {
-	std::regex reg("^[a-zA-Z]{3}$");
-	if (std::regex_match(lang, reg)) {
-		std::string langLowercase = BethYw::toLowercase(lang);
-		names[langLowercase] = name;
-	} else {
+void Area::setName(const std::string& lang, const std::string& name) {
+	bool validLang = lang.length() == 3;
+	bool lowercase = true;
+	for (std::string::size_type i = 0; i < lang.length() && validLang; i++) {
+		if (lang[i] >= 'A' && lang[i] <= 'Z') {
+			lowercase = false;
+		} else {
+			validLang = lang[i] >= 'a' && lang[i] <= 'z';
+		}
+	}
+	if (!validLang) {
 		throw std::invalid_argument("Area::setName: Language code must be three alphabetical letters only");
 	}
+
+	// Language codes are almost always given in lowercase already, so a
+	// lowercase copy is only built for one that is not
+	if (!lowercase) {
+		setName(BethYw::toLowercase(lang), name);
+		return;
+	}
+
+	// Setting the same name again is common when importing rows, so only
+	// intern a name that has changed
+	auto it = names.find(lang);
+	if (it == names.end()) {
+		names.insert(std::make_pair(lang, BethYw::intern(name)));
+	} else if (it->second.str() != name) {
+		it->second = BethYw::intern(name);
+	}
 }
 
 
@@ -148,19 +202,44 @@ void Area::setName(std::string lang, const std::string name) {
     ...
     auto measure2 = area.getMeasure("pop");
 */
-Measure& Area::getMeasure(const std::string key) {
-	std::string lowercaseKey = BethYw::toLowercase(key);
-	auto itFound = measures.end();
-	for (auto it = measures.begin(); it != measures.end(); it++) {
-		if (it->first == lowercaseKey) {
-			itFound = it;
-			break;
+Measure& Area::getMeasure(const std::string& key) {
+	Measure* measure = findMeasure(key);
+	if (measure == nullptr) {
+		throw std::out_of_range("No measure found matching " + key);
+	}
+	return *measure;
+}
+
+/*
+	findMeasure(key)
+	Returns a pointer to the Measure with a codename, ignoring case, or
+	nullptr if there is none. Unlike getMeasure(), this does not throw if
+	there is no Measure. Once this thread has seen the codename, a lookup
+	hashes the key, finds its Symbol without locking and searches the
+	Measures by comparing handles.
+
+	@example
+		Measure* measure = area.findMeasure("pop");
+		if (measure != nullptr) {
+			...
 		}
+*/
+Measure* Area::findMeasure(const std::string& key) {
+	return const_cast<Measure*>(static_cast<const Area*>(this)->findMeasure(key));
+}
+
+const Measure* Area::findMeasure(const std::string& key) const {
+	// The measures are keyed by the interned lowercase codename, which is
+	// found without building a lowercase copy of the key
+	BethYw::Symbol codename;
+	if (!BethYw::findLowercaseSymbol(key, codename)) {
+		return nullptr;
 	}
-	if (itFound == measures.end()) {
-		throw std::out_of_range("No measure found matching " + key);
+	auto it = measures.find(codename);
+	if (it == measures.end()) {
+		return nullptr;
 	}
-	return itFound->second;
+	return &it->second;
 }
 
 /*
@@ -195,14 +274,51 @@ Measure& Area::getMeasure(const std::string key) {
 
     area.setMeasure(codename, measure);
 */
-void Area::setMeasure(const std::string codename, const Measure measure) {
-	std::string lowercaseCodename = BethYw::toLowercase(codename);
+void Area::setMeasure(const std::string& codename, Measure measure) {
+	BethYw::Symbol lowercaseCodename = BethYw::internLowercase(codename);
 	auto it = measures.find(lowercaseCodename);
 	if (it != measures.end()) {
-		it->second = it->second + measure;
+		it->second.merge(measure);
 	} else {
-		measures.insert(std::pair<std::string, Measure>(lowercaseCodename, measure));
+		measures.insert(std::make_pair(lowercaseCodename, std::move(measure)));
+		indexMeasure(lowercaseCodename);
+	}
+}
+
+/*
+  Area::upsertMeasure(codename, label)
+
+  Find the Measure with the given codename, or add an empty one if there is
+  none, so values can be set on it in place. The label replaces any existing
+  label, as it would if a Measure with this label were passed to setMeasure().
+
+  This is how rows are imported: setMeasure() would merge a new Measure in to
+  the existing one for every row.
+
+  @param codename
+    The codename for the Measure, which is converted to lowercase
+
+  @param label
+    The label for the Measure
+
+  @return
+    A reference to the Measure stored in this Area
+
+  @example
+    Area area("W06000023");
+    area.upsertMeasure("Pop", "Population").setValue(1999, 12345678.9);
+*/
+Measure& Area::upsertMeasure(const std::string& codename, const std::string& label) {
+	BethYw::Symbol lowercaseCodename = BethYw::internLowercase(codename);
+	auto it = measures.find(lowercaseCodename);
+	if (it == measures.end()) {
+		Measure measure(codename, label, measures.get_allocator().getArena());
+		it = measures.insert(it, std::make_pair(lowercaseCodename, std::move(measure)));
+		indexMeasure(lowercaseCodename);
+	} else if (it->second.getLabel() != label) {
+		it->second.setLabel(label);
 	}
+	return it->second;
 }
 
 /*
@@ -265,20 +381,12 @@ const int Area::size() const noexcept{
     area.setName("eng", "Powys");
     std::cout << area << std::endl;
 */
-std::ostream &operator<<(std::ostream &output, const Area area) {
+std::ostream &operator<<(std::ostream &output, const Area& area) {
 	std::string topLine = "";
-	std::string englishName = "";
-	std::string welshName = "";
-	try {
-		englishName = area.getName("eng");
-	} catch (const std::out_of_range& e) {
-		englishName = "";
-	}
-	try {
-		welshName = area.getName("cym");
-	} catch (const std::out_of_range& e) {
-		welshName = "";
-	}
+	const std::string* found = area.findName("eng");
+	const std::string englishName = found != nullptr ? *found : "";
+	found = area.findName("cym");
+	const std::string welshName = found != nullptr ? *found : "";
 	if (englishName == "" && welshName == "") {
 		topLine += "Unnamed";
 	} else if (englishName == ""){
@@ -291,9 +399,9 @@ std::ostream &operator<<(std::ostream &output, const Area area) {
 	topLine += " (" + area.getLocalAuthorityCode() + ")";
 	output << topLine << std::endl;
 	if (area.measures.size()) {
-		for (auto it = area.measures.begin(); it != area.measures.end(); it++) {
-			output << it->second;
-		}
+		area.forEachMeasure([&output](const std::string& codename, const Measure& measure) {
+			output << measure;
+		});
 	} else {
 		output << "<no measures>";
 	}
@@ -323,9 +431,9 @@ std::ostream &operator<<(std::ostream &output, const Area area) {
 
     bool eq = area1 == area2;
 */
-bool operator==(const Area lhs, const Area rhs) {
+bool operator==(const Area& lhs, const Area& rhs) {
 	return (lhs.names == rhs.names &&
-		lhs.getLocalAuthorityCode() == rhs.getLocalAuthorityCode() &&
+		lhs.localAuthorityCode == rhs.localAuthorityCode &&
 		lhs.measures == rhs.measures);
 }
 
@@ -334,7 +442,11 @@ bool operator==(const Area lhs, const Area rhs) {
 	Get the names map of the area.
 */
 const std::map<std::string, std::string> Area::getNames() const {
-	return names;
+	std::map<std::string, std::string> namesCopy;
+	for (auto it = names.begin(); it != names.end(); it++) {
+		namesCopy.insert(namesCopy.end(), std::make_pair(it->first, it->second.str()));
+	}
+	return namesCopy;
 }
 
 /*
@@ -342,7 +454,23 @@ const std::map<std::string, std::string> Area::getNames() const {
 	Get the measures map of an area.
 */
 const std::map<std::string, Measure> Area::getMeasures() const {
-	return measures;
+	std::map<std::string, Measure> measuresCopy;
+	for (auto it = measures.begin(); it != measures.end(); it++) {
+		measuresCopy.insert(std::make_pair(it->first.str(), it->second));
+	}
+	return measuresCopy;
+}
+
+/*
+	indexMeasure(codename)
+	Add the codename of a newly inserted Measure to measureOrder, keeping it
+	in alphabetical order. The map itself is ordered by the handles of the
+	codenames, so this is what forEachMeasure() iterates.
+*/
+void Area::indexMeasure(const BethYw::Symbol codename) {
+	measureOrder.insert(
+		std::lower_bound(measureOrder.begin(), measureOrder.end(), codename, BethYw::SymbolOrder()),
+		codename);
 }
 
 /*
@@ -350,11 +478,60 @@ const std::map<std::string, Measure> Area::getMeasures() const {
 	Join the rhs Area with the lhs Area and replace items in lhs with rhs.
 */
 Area operator+(Area lhs, const Area& rhs) {
-	for (auto it = rhs.names.begin(); it != rhs.names.end(); it++) {
-		lhs.setName(it->first, it->second);
+	lhs.merge(rhs);
+	return lhs;
+}
+
+/*
+	merge(other)
+	Add the names and Measures of other to this Area in place, as operator+
+	does, with the data in other taking precedence. The names and codenames
+	of other have already been checked and interned.
+
+	@param other
+		The Area to merge in to this one
+*/
+void Area::merge(const Area& other) {
+	for (auto it = other.names.begin(); it != other.names.end(); it++) {
+		names[it->first] = it->second;
 	}
-	for (auto it = rhs.measures.begin(); it != rhs.measures.end(); it++) {
-		lhs.setMeasure(it->first, it->second);	
+	for (auto it = other.measures.begin(); it != other.measures.end(); it++) {
+		auto found = measures.find(it->first);
+		if (found == measures.end()) {
+			Measure measure(it->second.getCodename(), it->second.getLabel(), measures.get_allocator().getArena());
+			found = measures.insert(found, std::make_pair(it->first, std::move(measure)));
+			indexMeasure(it->first);
+		}
+		found->second.merge(it->second);
 	}
-	return lhs;
+}
+
+/*
+	getMemoryUsage()
+	Estimate the memory used by this Area: the object itself, its names and
+	its Measures, and the interned strings it refers to. Strings shared with
+	other Areas are counted once per Area here; Areas::getMemoryUsage()
+	counts each only once.
+
+	@return
+		The approximate memory usage of the Area
+*/
+const BethYw::MemoryUsage Area::getMemoryUsage() const noexcept {
+	BethYw::MemoryUsage usage;
+	usage.overhead = sizeof(Area);
+	usage.strings = BethYw::internedStringSize(localAuthorityCode.str());
+	for (auto it = names.begin(); it != names.end(); it++) {
+		usage.names += BethYw::MAP_NODE_OVERHEAD
+			+ sizeof(std::pair<const std::string, BethYw::Symbol>)
+			+ BethYw::stringHeapSize(it->first);
+		usage.strings += BethYw::internedStringSize(it->second.str());
+	}
+	usage.measures += measureOrder.capacity() * sizeof(BethYw::Symbol);
+	for (auto it = measures.begin(); it != measures.end(); it++) {
+		usage.measures += BethYw::MAP_NODE_OVERHEAD + sizeof(BethYw::Symbol);
+		usage += it->second.getMemoryUsage();
+		usage.strings += BethYw::internedStringSize(it->second.getCodename())
+			+ BethYw::internedStringSize(it->second.getLabel());
+	}
+	return usage;
 }
@@ -19,7 +19,11 @@
 #include <string>
 #include <map>
 #include <iostream>
+#include <vector>
+#include "arena.h"
 #include "measure.h"
+#include "memory.h"
+#include "symbols.h"
 
 #include "lib_json.hpp"
 using json = nlohmann::json;
@@ -28,28 +32,77 @@ using json = nlohmann::json;
     for the area in any number of different languages, and a container for the
     Measures objects.
 
+    The code, names and measure codenames are interned (see symbols.h). The
+    Measures are keyed by the handle of their codename, so looking one up
+    compares pointers rather than strings. A separate index of the codenames
+    is kept in alphabetical order as Measures are added, so they can be
+    output in order without sorting or allocating.
+
     TODO: Based on your implementation, there may be additional constructors
     or functions you implement here, and perhaps additional operators you may wish
     to overload.
 */
 class Area {
  private:
- 	std::string localAuthorityCode;
- 	std::map<std::string, std::string> names;
-	std::map<std::string, Measure> measures;
+ 	BethYw::Symbol localAuthorityCode;
+ 	std::map<std::string,
+		BethYw::Symbol,
+		std::less<std::string>,
+		BethYw::ArenaAllocator<std::pair<const std::string, BethYw::Symbol>>> names;
+	std::map<BethYw::Symbol,
+		Measure,
+		BethYw::SymbolHandleOrder,
+		BethYw::ArenaAllocator<std::pair<const BethYw::Symbol, Measure>>> measures;
+	std::vector<BethYw::Symbol, BethYw::ArenaAllocator<BethYw::Symbol>> measureOrder;
+
+	void indexMeasure(const BethYw::Symbol codename);
 public:
 	Area(const std::string& localAuthorityCode);
+	Area(const std::string& localAuthorityCode, std::shared_ptr<BethYw::Arena> arena);
+	Area(const Area& other) = default;
+	Area(Area&& other) = default;
 	~Area() = default;
-	const std::string getLocalAuthorityCode() const;
-	const std::string getName(const std::string lang) const;
-	void setName(const std::string lang, const std::string name);
-	Measure& getMeasure(const std::string key);
-	void setMeasure(const std::string codename, const Measure measure);
+	Area& operator=(const Area& other) = default;
+	Area& operator=(Area&& other) = default;
+	const std::string& getLocalAuthorityCode() const;
+	const std::string& getName(const std::string lang) const;
+	const std::string* findName(const std::string& lang) const noexcept;
+	void setName(const std::string& lang, const std::string& name);
+	Measure& getMeasure(const std::string& key);
+	Measure* findMeasure(const std::string& key);
+	const Measure* findMeasure(const std::string& key) const;
+	void setMeasure(const std::string& codename, Measure measure);
+	Measure& upsertMeasure(const std::string& codename, const std::string& label);
 	const int size() const noexcept;
-	friend std::ostream &operator<<(std::ostream &output, const Area area);
-	friend bool operator==(const Area lhs, const Area rhs);
+	friend std::ostream &operator<<(std::ostream &output, const Area& area);
+	friend bool operator==(const Area& lhs, const Area& rhs);
 	const std::map<std::string, std::string> getNames() const;
 	const std::map<std::string, Measure> getMeasures() const;
+
+	/*
+	    Call fn(lang, name) for every name, in order of language code. Unlike
+	    getNames(), this does not copy the names.
+	*/
+	template <typename Fn>
+	void forEachName(Fn fn) const {
+		for (auto it = names.begin(); it != names.end(); it++) {
+			fn(it->first, it->second.str());
+		}
+	}
+
+	/*
+	    Call fn(codename, measure) for every Measure, in order of codename.
+	    Unlike getMeasures(), this does not copy the Measures.
+	*/
+	template <typename Fn>
+	void forEachMeasure(Fn fn) const {
+		for (auto it = measureOrder.begin(); it != measureOrder.end(); it++) {
+			fn(it->str(), measures.find(*it)->second);
+		}
+	}
+
+	void merge(const Area& other);
+	const BethYw::MemoryUsage getMemoryUsage() const noexcept;
 	friend Area operator+(Area lhs, const Area& rhs);
 	
 };
@@ -18,13 +18,18 @@
     must implement has a TODO block comment. 
 */
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <stdexcept>
 #include <iostream>
+#include <iterator>
 #include <string>
-#include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
-#include <sstream>
+#include <utility>
+#include <vector>
 
 #include "lib_json.hpp"
 
@@ -32,11 +37,22 @@
 #include "areas.h"
 #include "measure.h"
 #include "bethyw.h"
+#include "statswales.h"
+#include "csv.h"
+#include "input.h"
+#include "numbers.h"
+
 /*
     An alias for the imported JSON parsing library.
 */
 using json = nlohmann::json;
 
+/*
+    The smallest chunk of a StatsWales file that is worth parsing on a thread
+    of its own.
+*/
+constexpr std::size_t MIN_PARALLEL_CHUNK = 256 * 1024;
+
 /*
     TODO: Areas::Areas()
 
@@ -45,7 +61,27 @@ using json = nlohmann::json;
     @example
         Areas data = Areas();
 */
-Areas::Areas() {
+Areas::Areas() : reference(nullptr), parseThreads(1) {
+}
+
+/*
+    Areas::Areas(arena)
+
+    Construct an Areas object whose Areas, names, Measures and readings are
+    all allocated from an Arena (see arena.h), which is released all at once
+    when the last of them is destroyed. This suits the command line program,
+    which loads everything, outputs it and exits.
+
+    @param arena
+        The Arena to allocate from
+
+    @example
+        Areas data(std::make_shared<BethYw::Arena>());
+*/
+Areas::Areas(std::shared_ptr<BethYw::Arena> arena)
+	: areas(AreasContainer::allocator_type(arena)),
+	reference(nullptr),
+	parseThreads(1) {
 }
 
 /*
@@ -73,15 +109,44 @@ Areas::Areas() {
         Area area(localAuthorityCode);
         data.setArea(localAuthorityCode, area);
 */
-void Areas::setArea(const std::string localAuthorityCode, Area area) {
-	auto it = areas.find(localAuthorityCode);
+void Areas::setArea(const std::string& localAuthorityCode, Area area) {
+	BethYw::AuthorityCode code = BethYw::AuthorityCode::parse(localAuthorityCode);
+	auto it = areas.find(code);
 	if (it != areas.end()) {
-		it->second = it->second + area;
+		it->second.merge(area);
 	} else {
-		areas.insert(std::pair<std::string, Area>(localAuthorityCode, area));
+		areas.insert(std::make_pair(code, std::move(area)));
 	}
 }
 
+/*
+    Areas::upsertArea(localAuthorityCode)
+
+    Find the Area with a given local authority code, or add an empty one if
+    there is none, so that names and Measures can be set on it in place.
+
+    The populate functions use this for each row instead of building an Area
+    and passing it to setArea(), which would merge it in to the existing Area.
+
+    @param localAuthorityCode
+        The local authority code of the Area
+
+    @return
+        A reference to the Area stored in this Areas instance
+
+    @example
+        Areas data = Areas();
+        data.upsertArea("W06000023").setName("eng", "Powys");
+*/
+Area& Areas::upsertArea(const std::string& localAuthorityCode) {
+	BethYw::AuthorityCode code = BethYw::AuthorityCode::parse(localAuthorityCode);
+	auto it = areas.find(code);
+	if (it == areas.end()) {
+		it = areas.insert(it, std::make_pair(code, Area(localAuthorityCode, getArena())));
+	}
+	return it->second;
+}
+
 /*
     TODO: Areas::getArea(localAuthorityCode)
 
@@ -105,12 +170,49 @@ void Areas::setArea(const std::string localAuthorityCode, Area area) {
         ...
         Area area2 = areas.getArea("W06000023");
 */
-Area& Areas::getArea(const std::string localAuthorityCode){
-	auto it = areas.find(localAuthorityCode);
-	if (it == areas.end()) {
+Area& Areas::getArea(const std::string& localAuthorityCode){
+	Area* area = findArea(localAuthorityCode);
+	if (area == nullptr) {
 		throw std::out_of_range("No area found matching " + localAuthorityCode);
 	}
-	return it->second;
+	return *area;
+}
+
+/*
+    Areas::findArea(localAuthorityCode)
+
+    Find an Area instance with a given local authority code. Unlike getArea(),
+    this does not throw if there is no such Area, so it suits checking for
+    an Area in a loop.
+
+    @param localAuthorityCode
+        The local authority code to find the Area instance of
+
+    @return
+        A pointer to the Area, or nullptr if there is none
+
+    @example
+        Areas data = Areas();
+        ...
+        Area* area = data.findArea("W06000023");
+        if (area != nullptr) {
+            ...
+        }
+*/
+Area* Areas::findArea(const std::string& localAuthorityCode) {
+	return const_cast<Area*>(static_cast<const Areas*>(this)->findArea(localAuthorityCode));
+}
+
+const Area* Areas::findArea(const std::string& localAuthorityCode) const {
+	BethYw::AuthorityCode code;
+	if (!BethYw::AuthorityCode::find(localAuthorityCode, code)) {
+		return nullptr;
+	}
+	auto it = areas.find(code);
+	if (it == areas.end()) {
+		return nullptr;
+	}
+	return &it->second;
 }
 
 /*
@@ -135,6 +237,136 @@ const int Areas::size() const noexcept {
 	return areas.size();
 }
 
+/*
+    Areas::setReference(reference)
+
+    Set another Areas instance whose Area objects count as already imported
+    when deciding if a row is in the areas filter (see isSubstringOfArea()).
+    This lets a dataset be parsed in to its own, empty, Areas instance while
+    still filtering as if it were parsed in to the instance holding areas.csv.
+
+    The reference is only read, and must outlive this instance's populate()
+    calls.
+
+    @param reference
+        The Areas instance to consult, or nullptr for none
+
+    @example
+        Areas data = Areas();
+        BethYw::loadAreas(data, "data", areasFilter);
+
+        Areas partial = Areas();
+        partial.setReference(&data);
+*/
+void Areas::setReference(const Areas* reference) noexcept {
+	this->reference = reference;
+}
+
+/*
+    Areas::setParseThreads(threads)
+
+    Set the number of threads used to parse a single StatsWales JSON file. With
+    more than one thread, the file is read in to memory (unless it already is,
+    e.g. through InputMappedFile) and the rows of its "value" array are split
+    in to chunks that are parsed at the same time. Files that are too small to
+    be worth splitting are still parsed on one thread.
+
+    @param threads
+        The number of threads, 1 (the default) to stream the file on the
+        calling thread
+
+    @example
+        Areas data = Areas();
+        data.setParseThreads(4);
+*/
+void Areas::setParseThreads(const unsigned int threads) noexcept {
+	parseThreads = threads;
+}
+
+/*
+    Areas::merge(other)
+
+    Add every Area in another Areas instance to this one, in the same way as
+    setArea(), so the other instance's data takes precedence.
+
+    @param other
+        The Areas instance to merge in to this one
+
+    @example
+        Areas data = Areas();
+        Areas partial = Areas();
+        ...
+        data.merge(partial);
+*/
+void Areas::merge(const Areas& other) {
+	for (auto it = other.areas.begin(); it != other.areas.end(); it++) {
+		auto found = areas.find(it->first);
+		if (found == areas.end()) {
+			found = areas.insert(found, std::make_pair(it->first, Area(it->second.getLocalAuthorityCode(), getArena())));
+		}
+		found->second.merge(it->second);
+	}
+}
+
+/*
+    Areas::merge(other)
+
+    As above, but Areas that are only in other are moved rather than copied,
+    keeping the Arena they were allocated from (if any) alive. other is left
+    empty.
+
+    @param other
+        The Areas instance to merge in to this one
+
+    @example
+        Areas data = Areas();
+        Areas partial = data.makePartial();
+        ...
+        data.merge(std::move(partial));
+*/
+void Areas::merge(Areas&& other) {
+	for (auto it = other.areas.begin(); it != other.areas.end(); it++) {
+		auto found = areas.find(it->first);
+		if (found != areas.end()) {
+			found->second.merge(it->second);
+		} else {
+			areas.insert(found, std::make_pair(it->first, std::move(it->second)));
+		}
+	}
+	other.areas.clear();
+}
+
+/*
+    Areas::getArena()
+
+    @return
+        The Arena this instance allocates from, or nullptr if it uses the heap
+*/
+std::shared_ptr<BethYw::Arena> Areas::getArena() const noexcept {
+	return areas.get_allocator().getArena();
+}
+
+/*
+    Areas::makePartial()
+
+    Create an empty Areas instance to import part of the data in to on
+    another thread, before merging it in to this one. It refers to this
+    instance for area names (see setReference()) and has an Arena of its own
+    if this instance has one, as an Arena must only be used by one thread.
+
+    @return
+        The new Areas instance
+
+    @example
+        Areas data = Areas();
+        Areas partial = data.makePartial();
+*/
+Areas Areas::makePartial() const {
+	Areas partial = getArena() ? Areas(std::make_shared<BethYw::Arena>()) : Areas();
+	partial.setReference(this);
+	return partial;
+}
+
 /*
     TODO: Areas::populateFromAuthorityCodeCSV(is, cols, areasFilter)
 
@@ -148,6 +380,9 @@ const int Areas::size() const noexcept {
     For this coursework, you can assume that areas.csv will always have the same
     three columns in the same order.
 
+    The file is split in to records and fields by a CsvReader (see csv.h),
+    which reuses a single buffer for the whole file.
+
     Once the data is parsed, you need to create the appropriate Area objects and
     insert them in to a Standard Library container within Areas.
 
@@ -159,8 +394,8 @@ const int Areas::size() const noexcept {
         that give the column header in the CSV file
 
     @param areasFilter
-        An umodifiable pointer to set of umodifiable strings for areas to import,
-        or an empty set if all areas should be imported
+        The compiled filter of areas to import (see filters.h), which may be
+        given as a pointer to a StringFilterSet, empty to import all areas
 
     @return
         void
@@ -189,25 +424,20 @@ const int Areas::size() const noexcept {
 void Areas::populateFromAuthorityCodeCSV(
         std::istream &is,
         const BethYw::SourceColumnMapping &cols,
-        const StringFilterSet * const areasFilter) {
+        const BethYw::StringFilter& areasFilter) {
 	
 	if (cols.size() != 3) {
 		throw std::out_of_range("Areas::populateFromAuthorityCodeCSV: Not enough values in cols");
 	}
 
 	if (is.good()){
-		std::string line;
-		int colIndex = 0;
-		std::getline(is, line);
-	
-		if (line.empty()) {
+		CsvReader reader(is);
+		if (!reader.readRecord()) {
 			throw std::runtime_error("Areas::populateFromAuthorityCodeCSV: File has no data");	
 		}
-		
-		std::istringstream ss(line);
-		std::string field;
 
-		while(std::getline(ss, field, ',')) {
+		int colIndex = 0;
+		for (auto& field : reader.fields()) {
 			if (field != cols.at(BethYw::AUTH_CODE) && colIndex == 0) {
 				throw (std::runtime_error("Areas::populateFromAuthorityCodeCSV: Malformed file"));
 			} else if (field != cols.at(BethYw::AUTH_NAME_ENG) && colIndex == 1) {
@@ -218,30 +448,29 @@ void Areas::populateFromAuthorityCodeCSV(
 			colIndex++;
 		}
 
-		while(std::getline(is, line)) {
-			std::istringstream ssData(line);
-			colIndex = 0;
-			std::string localAreaCode;
-			std::string engName;
-			std::string cywName;
-			while (std::getline(ssData, field, ',')) {
-				if (colIndex == 0) {
-					localAreaCode = field;
-				} else if (colIndex == 1) {
-					engName = field;
-				} else if (colIndex == 2){
-					cywName = field;
-				} else {				
-					throw (std::runtime_error("Areas::populateFromAuthorityCodeCSV: Malformed file"));
-				}
-				colIndex++;
+		std::string localAreaCode;
+		std::string engName;
+		std::string cywName;
+		while (reader.readRecord()) {
+			const std::vector<CsvField>& fields = reader.fields();
+			if (fields.size() > 3) {
+				throw (std::runtime_error("Areas::populateFromAuthorityCodeCSV: Malformed file"));
+			}
+			localAreaCode.assign(fields[0].data, fields[0].size);
+			engName.clear();
+			cywName.clear();
+			if (fields.size() > 1) {
+				engName.assign(fields[1].data, fields[1].size);
+			}
+			if (fields.size() > 2) {
+				cywName.assign(fields[2].data, fields[2].size);
 			}
+
 			bool addArea = isInFilter(localAreaCode, engName, cywName, areasFilter);
 			if (addArea) {
-				Area area(localAreaCode);
+				Area& area = upsertArea(localAreaCode);
 				area.setName("eng", engName);
 				area.setName("cym", cywName);
-				setArea(localAreaCode, area);
 			}
 		}
 	} else {
@@ -282,6 +511,13 @@ void Areas::populateFromAuthorityCodeCSV(
                      // do stuff here...
                 }
 
+    Rather than reading the whole file in to a json object, the file is
+    streamed through a WelshStatsHandler (see statswales.h), which hands us
+    one row of value at a time. This keeps memory use down to a single row,
+    no matter how large the file is. If more than one parse thread has been
+    set (see setParseThreads()), large files are instead split in to chunks
+    of rows that are parsed at the same time.
+
     In this function, you will have to parse the JSON datasets, extracting
     the local authority code, English name (the files only contain the English
     names), and each measure by year.
@@ -310,17 +546,17 @@ void Areas::populateFromAuthorityCodeCSV(
         that give the column header in the CSV file
 
     @param areasFilter
-        An umodifiable pointer to set of umodifiable strings of areas to import,
-        or an empty set if all areas should be imported
+        The compiled filter of areas to import (see filters.h), which may be
+        given as a pointer to a StringFilterSet, empty to import all areas
 
     @param measuresFilter
-        An umodifiable pointer to set of umodifiable strings of measures to import,
-        or an empty set if all measures should be imported
+        The compiled filter of measures to import, which may be given as a
+        pointer to a StringFilterSet, empty to import all measures
 
     @param yearsFilter
-        An umodifiable pointer to an umodifiable tuple of two unsigned integers,
-        where if both values are 0, then all years should be imported, otherwise
-        they should be treated as the range of years to be imported (inclusively)
+        The compiled range of years to import, which may be given as a pointer
+        to a YearFilterTuple, where if both values are 0 all years are imported,
+        otherwise the range is inclusive
 
     @return
         void
@@ -357,9 +593,9 @@ void Areas::populateFromAuthorityCodeCSV(
 void Areas::populateFromWelshStatsJSON(
     std::istream& is,
     const BethYw::SourceColumnMapping& cols,
-    const StringFilterSet * const areasFilter,
-	const StringFilterSet * const measuresFilter,
-	const YearFilterTuple * const yearsFilter)
+    const BethYw::StringFilter& areasFilter,
+	const BethYw::StringFilter& measuresFilter,
+	const BethYw::YearFilter& yearsFilter)
 	noexcept(false) {
 	
 	if (cols.size() != 6) {
@@ -367,63 +603,218 @@ void Areas::populateFromWelshStatsJSON(
 	}
 
 	if (is.good()) {
-		json j;
-		is >> j;
-		if (j.empty()) {
-			throw std::runtime_error("Areas::populateFromWelshStatsJSON: File has no data");	
+		if (parseThreads > 1) {
+			auto memory = dynamic_cast<InputMemoryBuffer*>(is.rdbuf());
+			if (memory != nullptr) {
+				populateFromWelshStatsJSON(memory->data(), memory->size(), cols,
+					areasFilter, measuresFilter, yearsFilter);
+			} else {
+				std::string document((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+				populateFromWelshStatsJSON(document.data(), document.size(), cols,
+					areasFilter, measuresFilter, yearsFilter);
+			}
+			return;
 		}
 
-		for (auto& el : j["value"].items()) {
-			auto &data = el.value();
-        	std::string authCode;
-        	std::string authName;
-        	std::string measureCode;
-        	std::string measureName;
-        	unsigned int year;
-			double value;
-
-			try {	
-				authCode = data[cols.at(BethYw::AUTH_CODE)].get<std::string>();
-				authName = data[cols.at(BethYw::AUTH_NAME_ENG)].get<std::string>();
-				if (cols.count(BethYw::MEASURE_CODE)) {
-					measureCode = data[cols.at(BethYw::MEASURE_CODE)].get<std::string>();
-					measureName = data[cols.at(BethYw::MEASURE_NAME)].get<std::string>();			
-				} else {
-					measureCode = cols.at(BethYw::SINGLE_MEASURE_CODE);
-					measureName = cols.at(BethYw::SINGLE_MEASURE_NAME);
-				}
-				std::string yearString = data[cols.at(BethYw::YEAR)].get<std::string>();
-				year = std::stoul(yearString, nullptr);			
-				try {
-					value = data[cols.at(BethYw::VALUE)].get<double>();
-				} catch (const nlohmann::detail::type_error& e) {
-					std::string strValue = data[cols.at(BethYw::VALUE)].get<std::string>();
-					value = std::stod(strValue, nullptr);
-				}		
-			} catch (const std::out_of_range& e) {
-				throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+		RejectedAreas rejected;
+		auto addRow = [&](const WelshStatsRow& row) {
+			addWelshStatsRow(row, rejected, areasFilter, measuresFilter, yearsFilter);
+		};
+		auto keepRow = [&](const WelshStatsRow& row, const unsigned int read) {
+			return keepWelshStatsRow(row, read, rejected, areasFilter, measuresFilter, yearsFilter);
+		};
+
+		bool parsed = false;
+		try {
+			WelshStatsHandler handler(cols, addRow, keepRow);
+			parsed = handler.parse(is);
+			if (!handler.hasData()) {
+				throw std::runtime_error("Areas::populateFromWelshStatsJSON: File has no data");
 			}
-	
-			bool inAreasFilter = isInFilter(authCode, authName, "", areasFilter); 
-			bool inMeasuresFilter = isInFilter(measureCode, measuresFilter);	
-			bool yearInRange = isInFilter(year, yearsFilter);
-
-			if (inAreasFilter) {
-				Area area = Area(authCode);
-				area.setName("eng", authName);
-				if (inMeasuresFilter && yearInRange) {
-					Measure measure(measureCode, measureName);
-					measure.setValue(year, value);
-					area.setMeasure(measureCode, measure);
-				}
-				setArea(authCode, area);
-			}
-		}	
+		} catch (const std::out_of_range& e) {
+			throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+		}
+		if (!parsed) {
+			throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+		}
 	} else {
 		throw std::runtime_error("Areas::populateFromWelshStatsJSON: Error reading file");
 	}
 }
 
+/*
+	populateFromWelshStatsJSON(data, size, cols, areasFilter, measuresFilter, yearsFilter)
+	Parse a StatsWales file held in memory using up to parseThreads threads.
+	Each chunk of rows is parsed in to its own Areas instance, and these are
+	merged in document order so later rows still replace earlier ones. The
+	rest of the document is checked as the sequential parse checks it, so
+	the same files are rejected whatever the number of threads.
+*/
+void Areas::populateFromWelshStatsJSON(
+	const char* data,
+	std::size_t size,
+	const BethYw::SourceColumnMapping& cols,
+	const BethYw::StringFilter& areasFilter,
+	const BethYw::StringFilter& measuresFilter,
+	const BethYw::YearFilter& yearsFilter) {
+
+	std::size_t count = std::min<std::size_t>(parseThreads, size / MIN_PARALLEL_CHUNK);
+	if (count <= 1) {
+		bool parsed = false;
+		RejectedAreas rejected;
+		try {
+			WelshStatsHandler handler(cols,
+				[&](const WelshStatsRow& row) {
+					addWelshStatsRow(row, rejected, areasFilter, measuresFilter, yearsFilter);
+				},
+				[&](const WelshStatsRow& row, const unsigned int read) {
+					return keepWelshStatsRow(row, read, rejected, areasFilter, measuresFilter, yearsFilter);
+				});
+			parsed = handler.parse(data, size);
+			if (!handler.hasData()) {
+				throw std::runtime_error("Areas::populateFromWelshStatsJSON: File has no data");
+			}
+		} catch (const std::out_of_range& e) {
+			throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+		}
+		if (!parsed) {
+			throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+		}
+		return;
+	}
+
+	std::vector<WelshStatsChunk> chunks;
+	bool hasData = false;
+	bool balanced = splitWelshStatsRows(data, size, count, chunks, hasData);
+	if (!hasData) {
+		throw std::runtime_error("Areas::populateFromWelshStatsJSON: File has no data");
+	}
+	if (!balanced) {
+		throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+	}
+
+	// The chunks only check the rows, so the rest of the document (e.g. the
+	// metadata and "odata.nextLink") is checked by the sequential parser, as
+	// if the "value" array were empty. Without a "value" array, this checks
+	// the whole document.
+	std::string outside;
+	if (chunks.empty()) {
+		outside.assign(data, size);
+	} else {
+		outside.assign(data, chunks.front().first);
+		outside.append(data + chunks.back().second, size - chunks.back().second);
+	}
+	try {
+		WelshStatsHandler handler(cols, [](const WelshStatsRow&) {});
+		if (!handler.parse(outside.data(), outside.size())) {
+			throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+		}
+	} catch (const std::out_of_range& e) {
+		throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+	}
+
+	std::vector<Areas> partials;
+	for (std::size_t i = 0; i < chunks.size(); i++) {
+		partials.push_back(makePartial());
+	}
+	std::vector<std::exception_ptr> errors(chunks.size());
+	std::atomic<std::size_t> next(0);
+
+	auto worker = [&]() {
+		for (std::size_t i = next++; i < chunks.size(); i = next++) {
+			try {
+				Areas& partial = partials[i];
+				RejectedAreas rejected;
+				WelshStatsHandler handler(cols,
+					[&](const WelshStatsRow& row) {
+						partial.addWelshStatsRow(row, rejected, areasFilter, measuresFilter, yearsFilter);
+					},
+					[&](const WelshStatsRow& row, const unsigned int read) {
+						return partial.keepWelshStatsRow(row, read, rejected, areasFilter, measuresFilter, yearsFilter);
+					});
+				if (!handler.parseRows(data + chunks[i].first, chunks[i].second - chunks[i].first)) {
+					throw std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed");
+				}
+			} catch (const std::out_of_range& e) {
+				errors[i] = std::make_exception_ptr(
+					std::runtime_error("Areas::populateFromWelshStatsJSON: File is malformed"));
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	std::size_t numWorkers = std::min<std::size_t>(parseThreads, chunks.size());
+	for (std::size_t i = 0; i < numWorkers; i++) {
+		workers.push_back(std::thread(worker));
+	}
+	for (auto it = workers.begin(); it != workers.end(); it++) {
+		it->join();
+	}
+
+	for (std::size_t i = 0; i < partials.size(); i++) {
+		if (errors[i]) {
+			std::rethrow_exception(errors[i]);
+		}
+		merge(std::move(partials[i]));
+	}
+}
+
+/*
+	keepWelshStatsRow(row, read, rejected, areasFilter, measuresFilter, yearsFilter)
+	Decide from the fields of a StatsWales row read so far (see
+	WelshStatsHandler::RowPredicate) if the rest of the row is needed, so rows
+	that addWelshStatsRow() would ignore are not copied in full. The year and
+	measure are checked first, as they are the cheapest. A row outside them
+	is still needed if it is the first row for an area, as it creates the
+	area and gives its name. A row for a new area is rejected once its name
+	shows it is not in the areas filter.
+*/
+const bool Areas::keepWelshStatsRow(const WelshStatsRow& row,
+	const unsigned int read,
+	RejectedAreas& rejected,
+	const BethYw::StringFilter& areasFilter,
+	const BethYw::StringFilter& measuresFilter,
+	const BethYw::YearFilter& yearsFilter) const {
+	const bool hasReading =
+		(!(read & WelshStatsHandler::YEAR) || yearsFilter.contains(row.year))
+		&& (!(read & WelshStatsHandler::MEASURE_CODE) || measuresFilter.contains(row.measureCode));
+	if (!(read & WelshStatsHandler::AUTH_CODE)) {
+		return true;
+	}
+	if (findArea(row.authCode) != nullptr) {
+		return hasReading;
+	}
+	if (read & WelshStatsHandler::AUTH_NAME) {
+		return isInFilter(row.authCode, row.authName, "", areasFilter, &rejected);
+	}
+	return true;
+}
+
+/*
+	addWelshStatsRow(row, rejected, areasFilter, measuresFilter, yearsFilter)
+	Add a single row of a StatsWales file, if it is in the filters. rejected
+	holds the areas rejected by the areas filter so far in the file.
+*/
+void Areas::addWelshStatsRow(const WelshStatsRow& row,
+	RejectedAreas& rejected,
+	const BethYw::StringFilter& areasFilter,
+	const BethYw::StringFilter& measuresFilter,
+	const BethYw::YearFilter& yearsFilter) {
+	bool inAreasFilter = isInFilter(row.authCode, row.authName, "", areasFilter, &rejected);
+	bool inMeasuresFilter = measuresFilter.contains(row.measureCode);
+	bool yearInRange = yearsFilter.contains(row.year);
+
+	if (inAreasFilter) {
+		Area& area = upsertArea(row.authCode);
+		area.setName("eng", row.authName);
+		if (inMeasuresFilter && yearInRange) {
+			area.upsertMeasure(row.measureCode, row.measureName).setValue(row.year, row.value);
+		}
+	}
+}
+
 /*
     TODO: Areas::populateFromAuthorityByYearCSV(is,
                                                                                             cols,
@@ -439,6 +830,9 @@ void Areas::populateFromWelshStatsJSON(
     have to rely on the names already populated through 
     Areas::populateFromAuthorityCodeCSV();
 
+    As with areas.csv, the file is split in to fields by a CsvReader. Rows for
+    areas that are not in the filter are skipped before any values are parsed.
+
     The datasets that will be parsed by this function are
      - complete-popu1009-area.csv
      - complete-popu1009-pop.csv
@@ -452,17 +846,17 @@ void Areas::populateFromWelshStatsJSON(
         that give the column header in the CSV file
 
     @param areasFilter
-        An umodifiable pointer to set of umodifiable strings for areas to import,
-        or an empty set if all areas should be imported
+        The compiled filter of areas to import (see filters.h), which may be
+        given as a pointer to a StringFilterSet, empty to import all areas
 
     @param measuresFilter
-        An umodifiable pointer to set of strings for measures to import, or an empty 
-        set if all measures should be imported
+        The compiled filter of measures to import, which may be given as a
+        pointer to a StringFilterSet, empty to import all measures
 
     @param yearsFilter
-        An umodifiable pointer to an umodifiable tuple of two unsigned integers,
-        where if both values are 0, then all years should be imported, otherwise
-        they should be treated as a the range of years to be imported
+        The compiled range of years to import, which may be given as a pointer
+        to a YearFilterTuple, where if both values are 0 all years are imported,
+        otherwise the range is inclusive
 
     @return
         void
@@ -493,63 +887,67 @@ void Areas::populateFromWelshStatsJSON(
 void Areas::populateFromAuthorityByYearCSV(
     std::istream& is,
     const BethYw::SourceColumnMapping& cols,
-    const StringFilterSet * const areasFilter,
-	const StringFilterSet * const measuresFilter,
-	const YearFilterTuple * const yearsFilter)
+    const BethYw::StringFilter& areasFilter,
+	const BethYw::StringFilter& measuresFilter,
+	const BethYw::YearFilter& yearsFilter)
     noexcept(false) {	
 
 	if (cols.size() != 3) {
 		throw std::out_of_range("Areas::populateFromAuthorityByYearCSV: Not enough values in cols");
 	}
 
-	if (isInFilter(cols.at(BethYw::SINGLE_MEASURE_CODE), measuresFilter)) {
+	if (measuresFilter.contains(cols.at(BethYw::SINGLE_MEASURE_CODE))) {
 		if (is.good()){
-			std::string line;
-			std::string field;
-			int colIndex = 0;
-			int numOfYears = 0;
-			std::vector<unsigned int> years;
-			std::getline(is, line);
-
-			if (line.empty()) {
+			CsvReader reader(is);
+			if (!reader.readRecord()) {
 				throw std::runtime_error("Areas::populateFromAuthorityByYearCSV: File has no data");	
 			}
 
-			std::istringstream ssFirstLine(line);
-			while (std::getline(ssFirstLine, field, ',')) {
-				if (colIndex != 0) {
-					years.push_back(std::stoul(field, nullptr));
-					numOfYears++;
+			std::vector<unsigned int> years;
+			const std::vector<CsvField>& header = reader.fields();
+			for (std::size_t i = 1; i < header.size(); i++) {
+				unsigned int year;
+				if (!BethYw::parseWholeNumber(header[i].data, header[i].data + header[i].size, year)) {
+					throw std::runtime_error("Areas::populateFromAuthorityByYearCSV: Malformed file");
 				}
-				colIndex++;
+				years.push_back(year);
 			}
+			std::size_t numOfYears = years.size();
+
+			// A row's values are all parsed before any are stored, so a
+			// malformed row leaves the Areas instance untouched
+			std::string authCode;
+			RejectedAreas rejected;
+			std::vector<std::pair<unsigned int, double>> readings;
+			readings.reserve(numOfYears);
+			while (reader.readRecord()) {
+				const std::vector<CsvField>& fields = reader.fields();
+				if (fields.size() > numOfYears + 1) {
+					throw std::runtime_error("Areas::populateFromAuthorityByYearCSV: Malformed file");
+				}
 
-			colIndex = 0;
-			while(std::getline(is, line)) {
-				std::istringstream ss(line);
-				std::string authCode;
-				Measure measure(cols.at(BethYw::SINGLE_MEASURE_CODE), cols.at(BethYw::SINGLE_MEASURE_NAME));
-				while(std::getline(ss, field, ',')) {
-					if (colIndex == 0) {
-						authCode = field;
-					} else if (colIndex <= numOfYears) {
-						bool yearInRange = isInFilter(years[(colIndex - 1)], yearsFilter);
+				authCode.assign(fields[0].data, fields[0].size);
+				bool inAreasFilter = isInFilter(authCode, "", "", areasFilter, &rejected);
+				if (inAreasFilter) {
+					readings.clear();
+					for (std::size_t i = 1; i < fields.size(); i++) {
+						bool yearInRange = yearsFilter.contains(years[i - 1]);
 						if (yearInRange) {
-							measure.setValue(years[(colIndex - 1)], std::stod(field));		
+							double value;
+							if (!BethYw::parseWholeNumber(fields[i].data, fields[i].data + fields[i].size, value)) {
+								throw std::runtime_error("Areas::populateFromAuthorityByYearCSV: Malformed file");
+							}
+							readings.push_back(std::make_pair(years[i - 1], value));
 						}
-					} else {
-						throw std::runtime_error("Areas::populateFromAuthorityByYearCSV: Malformed file");
 					}
-					colIndex++;
-				}
-			
-				bool inAreasFilter = isInFilter(authCode, "", "", areasFilter);
-				if (inAreasFilter) {	
-					Area area = Area(authCode);
-					area.setMeasure(cols.at(BethYw::SINGLE_MEASURE_CODE), measure);
-					setArea(authCode, area);
+
+					Measure& measure = upsertArea(authCode).upsertMeasure(
+						cols.at(BethYw::SINGLE_MEASURE_CODE),
+						cols.at(BethYw::SINGLE_MEASURE_NAME));
+					for (auto it = readings.begin(); it != readings.end(); it++) {
+						measure.setValue(it->first, it->second);
+					}
 				}
-				colIndex = 0;
 			}
 		} else {
 			throw std::runtime_error("Areas::populateFromAuthorityByYearCSV: Issue openeing file");
@@ -655,17 +1053,17 @@ void Areas::populate(std::istream &is,
         that give the column header in the CSV file
 
     @param areasFilter
-        An umodifiable pointer to set of umodifiable strings for areas to import,
-        or an empty set if all areas should be imported
+        The compiled filter of areas to import (see filters.h), which may be
+        given as a pointer to a StringFilterSet, empty to import all areas
 
     @param measuresFilter
-        An umodifiable pointer to set of umodifiable strings for measures to import,
-        or an empty set if all measures should be imported
+        The compiled filter of measures to import, which may be given as a
+        pointer to a StringFilterSet, empty to import all measures
 
     @param yearsFilter
-        An umodifiable pointer to an umodifiable tuple of two unsigned integers,
-        where if both values are 0, then all years should be imported, otherwise
-        they should be treated as a the range of years to be imported
+        The compiled range of years to import, which may be given as a pointer
+        to a YearFilterTuple, where if both values are 0 all years are imported,
+        otherwise the range is inclusive
 
     @return
         void
@@ -709,9 +1107,9 @@ void Areas::populate(
         std::istream &is,
         const BethYw::SourceDataType &type,
         const BethYw::SourceColumnMapping &cols,
-        const StringFilterSet * const areasFilter,
-        const StringFilterSet * const measuresFilter,
-        const YearFilterTuple * const yearsFilter) {
+        const BethYw::StringFilter& areasFilter,
+        const BethYw::StringFilter& measuresFilter,
+        const BethYw::YearFilter& yearsFilter) {
     if (type == BethYw::AuthorityCodeCSV) {
 		populateFromAuthorityCodeCSV(is, cols, areasFilter);
 	} else if (type == BethYw::WelshStatsJSON) {
@@ -797,35 +1195,36 @@ void Areas::populate(
         std::cout << data.toJSON();
 */
 std::string Areas::toJSON() const {
+	// The keys of a json object are kept sorted, so the Areas do not need to
+	// be visited in order
 	json j;
 	for (auto it = areas.begin(); it != areas.end(); it++) {
-		std::string localAuthCode = (it->second).getLocalAuthorityCode();
-		
-		std::map<std::string, std::string> names = (it->second).getNames();
-		json jsonNamesMap(names);
-
-		std::map<std::string, Measure> measures = (it->second).getMeasures();
-		json measuresObject;
-		for (auto itM = measures.begin(); itM != measures.end(); itM++) {
-			std::map<unsigned int, double> values = (itM->second).getValues();
-			std::map<std::string, double> valuesAsStrings;
-			for (auto itV = values.begin(); itV != values.end(); itV++) {
-				valuesAsStrings.insert(std::pair<std::string, double>(std::to_string(itV->first), itV->second));
-			}
-			json jMap(valuesAsStrings);
-			measuresObject[itM->first] = jMap;
-		}
+		const Area& area = it->second;
+
+		json jsonNamesMap = json::object();
+		area.forEachName([&jsonNamesMap](const std::string& lang, const std::string& name) {
+			jsonNamesMap[lang] = name;
+		});
+
+		json measuresObject = json::object();
+		area.forEachMeasure([&measuresObject](const std::string& codename, const Measure& measure) {
+			json jMap = json::object();
+			measure.forEachValue([&jMap](const unsigned int year, const double value) {
+				jMap[std::to_string(year)] = value;
+			});
+			measuresObject[codename] = std::move(jMap);
+		});
 
 		json measuresAndNameJson;
 		if (!measuresObject.empty()) {
-			measuresAndNameJson["measures"] = measuresObject;	
+			measuresAndNameJson["measures"] = std::move(measuresObject);
 		}
 
 		if (!jsonNamesMap.empty()) {
-			measuresAndNameJson["names"] = jsonNamesMap;
+			measuresAndNameJson["names"] = std::move(jsonNamesMap);
 		}
 
-		j[localAuthCode] = measuresAndNameJson;	
+		j[area.getLocalAuthorityCode()] = std::move(measuresAndNameJson);
 	}
 	std::string jsonOut;
 	if (areas.empty()) {
@@ -837,6 +1236,61 @@ std::string Areas::toJSON() const {
 	return jsonOut;
 }
 
+/*
+    Areas::getMemoryUsage()
+
+    Estimate the memory used by the imported data, broken down in to the names
+    of Areas, Measures, readings, interned strings and the Areas themselves.
+
+    Each interned string (codes, names, codenames and labels) is counted once,
+    however many Areas refer to it. Strings interned but no longer referred to
+    by any Area, e.g. by an Areas instance that has been destroyed, are not
+    counted.
+
+    @return
+        The approximate memory usage of the data
+
+    @throws
+        std::bad_alloc if there is not enough memory for the set of strings
+        that have been counted
+
+    @example
+        Areas data = Areas();
+        BethYw::loadAreas(data, dir, areasFilter);
+        std::cerr << data.getMemoryUsage().total() << std::endl;
+*/
+const BethYw::MemoryUsage Areas::getMemoryUsage() const {
+	BethYw::MemoryUsage usage;
+	std::unordered_set<const std::string*> strings;
+	for (auto it = areas.begin(); it != areas.end(); it++) {
+		const Area& area = it->second;
+		BethYw::MemoryUsage areaUsage = area.getMemoryUsage();
+		areaUsage.strings = 0;
+		usage += areaUsage;
+		usage.overhead += sizeof(BethYw::AuthorityCode);
+
+		strings.insert(&area.getLocalAuthorityCode());
+		area.forEachName([&strings](const std::string&, const std::string& name) {
+			strings.insert(&name);
+		});
+		area.forEachMeasure([&strings](const std::string& codename, const Measure& measure) {
+			strings.insert(&codename);
+			strings.insert(&measure.getLabel());
+		});
+	}
+
+#ifdef BETHYW_FLAT_AREAS
+	usage.overhead += areas.bucket_count() * sizeof(std::uint32_t);
+#else
+	usage.overhead += areas.size() * BethYw::MAP_NODE_OVERHEAD;
+#endif
+
+	for (auto it = strings.begin(); it != strings.end(); it++) {
+		usage.strings += BethYw::internedStringSize(**it);
+	}
+	return usage;
+}
+
 /*
     TODO: operator<<(os, areas)
 
@@ -943,97 +1397,61 @@ std::string Areas::toJSON() const {
         Areas areas();
         std::cout << areas << std::end;
 */
-std::ostream &operator<<(std::ostream &output, const Areas areas) {
-	for (auto it = areas.areas.begin(); it != areas.areas.end(); it++) {
-		output << it->second << std::endl;
-	}
+std::ostream &operator<<(std::ostream &output, const Areas& areas) {
+	areas.forEachArea([&output](const Area& area) {
+		output << area << std::endl;
+	});
 	return output;
 }
 
 /*
-	isInFilter(value, filter)
-	returns true if the value passed in is in the filter.
+	isInFilter(code, engName, cywName, filter, rejected)
+	Checks if a value in the filter is a substring of the code, english name or
+	welsh name, or if the area has already been imported. If rejected is given,
+	an area rejected before with the same names is rejected without searching
+	its names again, and a newly rejected area is added to it.
 */
-const bool Areas::isInFilter(std::string value, const StringFilterSet * const filter) const{
-	bool exists = 0;
-	if (filter != nullptr) {
-		if (!filter->empty()) {
-			std::string lowercaseValue = BethYw::toLowercase(value);
-			for (auto it = filter->begin(); it != filter->end(); it++) {
-				std::string lowercaseFilterValue = BethYw::toLowercase(*it);
-				if (lowercaseFilterValue == lowercaseValue) {
-					exists = 1;
-				}
-			}
-		} else {
-			exists = 1;
-		}
-	} else {
-		exists = 1;
+const bool Areas::isInFilter(const std::string& code,
+	const std::string& engName,
+	const std::string& cywName,
+	const BethYw::StringFilter& filter,
+	RejectedAreas* rejected) const {
+	if (filter.matchesAll() || isSubstringOfArea(code)) {
+		return true;
 	}
-	return exists;
-}
 
-/*
-	isInFilter(year, yearsFilter)
-	returns true if the year is in range of the tuple.
-*/
-const bool Areas::isInFilter(unsigned int year, const YearFilterTuple * const yearsFilter) const {
-	bool yearInRange = 1;
-	if (yearsFilter != nullptr) {
-		if (std::get<0>(*yearsFilter) != 0 && std::get<1>(*yearsFilter) != 0) {
-			if (year < std::get<0>(*yearsFilter) || year > std::get<1>(*yearsFilter)) {
-				yearInRange = 0;
-			}
+	if (rejected != nullptr) {
+		auto found = rejected->find(code);
+		if (found != rejected->end()
+			&& found->second.first == engName
+			&& found->second.second == cywName) {
+			return false;
 		}
 	}
-	return yearInRange;
-}
 
-/*
-	isInFilter(code, engName, cywName, filter)
-	Checks if a value in the filter is a substring of the code, english name or welsh name
-*/
-const bool Areas::isInFilter(std::string code, std::string engName, std::string cywName, const StringFilterSet * const filter){
-	bool exists = 0;
-	if (filter != nullptr) {
-		if (!filter->empty()) {
-			std::string lowercaseCode = BethYw::toLowercase(code);
-			std::string lowercaseEngName = BethYw::toLowercase(engName);
-			std::string lowercaseCywName = BethYw::toLowercase(cywName);
-
-			for (auto it = filter->begin(); it != filter->end(); it++) {
-				std::string lowercaseFilterValue = BethYw::toLowercase(*it);
-				if (lowercaseCode.find(lowercaseFilterValue) != std::string::npos && code != "") {
-					exists = 1;
-				} else if (lowercaseEngName.find(lowercaseFilterValue) != std::string::npos && engName != "") {
-					exists = 1;
-				} else if (lowercaseCywName.find(lowercaseFilterValue) != std::string::npos && cywName != "") {
-					exists = 1;
-				} else if (isSubstringOfArea(code)) {
-					exists = 1;
-				}
-			}
-		} else {
-			exists = 1;
-		}
-	} else {
-		exists = 1;
+	bool exists = filter.containsPartOf(code)
+		|| filter.containsPartOf(engName)
+		|| filter.containsPartOf(cywName);
+	if (!exists && rejected != nullptr) {
+		(*rejected)[code] = std::make_pair(engName, cywName);
 	}
 	return exists;
 }
 
 /*
 	isSubstringOfArea(code)
-	Takes a local auth code and returns true if that area object already exists.
+	Takes a local auth code and returns true if that area object already exists,
+	either in this instance or in one of its references (see setReference()).
 */
-const bool Areas::isSubstringOfArea(const std::string code) {
-	bool valuesMatchArea = 0;
-	try {
-		getArea(code);
-		valuesMatchArea = 1;
-	} catch (const std::out_of_range& e) {
-		valuesMatchArea = 0;
+const bool Areas::isSubstringOfArea(const std::string& code) const {
+	BethYw::AuthorityCode authorityCode;
+	if (!BethYw::AuthorityCode::find(code, authorityCode)) {
+		return false;
+	}
+	for (const Areas* it = this; it != nullptr; it = it->reference) {
+		if (it->areas.count(authorityCode) > 0) {
+			return true;
+		}
 	}
-	return valuesMatchArea;
+	return false;
 }
@@ -26,13 +26,26 @@
     functions and member variables you need to declare in this class.
  */
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 #include <map>
 #include "datasets.h"
+#include "arena.h"
 #include "area.h"
+#include "authority.h"
+#include "filters.h"
+#include "flatmap.h"
+#include "memory.h"
+#include "symbols.h"
+#include "statswales.h"
 
 /*
     An alias for filters based on strings such as categorisations e.g. area,
@@ -45,6 +58,13 @@ using StringFilterSet = std::unordered_set<std::string>;
 */
 using YearFilterTuple = std::tuple<unsigned int, unsigned int>;
 
+/*
+    The areas rejected by the areas filter while importing a file, by local
+    authority code, with the English and Welsh names they were rejected with.
+    Rows for an area that has already been rejected are not matched again.
+*/
+using RejectedAreas = std::unordered_map<std::string, std::pair<std::string, std::string>>;
+
 /*
     An alias for the data within an Areas object stores Area objects.
 
@@ -53,7 +73,26 @@ using YearFilterTuple = std::tuple<unsigned int, unsigned int>;
 */
 //class Null { };
 //TODO change this to a map so it will be in order and change functions for this!!
-using AreasContainer = std::map<std::string, Area>;
+//Keyed by the encoded authority code (see authority.h), ordered alphabetically.
+//Building with -DBETHYW_FLAT_AREAS uses a hash table instead (see flatmap.h),
+//which is faster to import in to when there are very many areas, and the
+//areas are sorted when they are output.
+#ifdef BETHYW_FLAT_AREAS
+using AreasContainer = BethYw::FlatMap<BethYw::AuthorityCode,
+	Area,
+	BethYw::AuthorityCodeHash,
+	std::equal_to<BethYw::AuthorityCode>,
+	BethYw::ArenaAllocator<std::pair<const BethYw::AuthorityCode, Area>>>;
+#else
+using AreasContainer = std::map<BethYw::AuthorityCode,
+	Area,
+	BethYw::AuthorityCodeOrder,
+	BethYw::ArenaAllocator<std::pair<const BethYw::AuthorityCode, Area>>>;
+#endif
+
+namespace BethYw {
+class Snapshot;
+} // namespace BethYw
 
 /*
     Areas is a class that stores all the data categorised by area. The 
@@ -72,34 +111,70 @@ using AreasContainer = std::map<std::string, Area>;
 class Areas {
 private:
 	AreasContainer areas;
-	const bool isInFilter(std::string value, const StringFilterSet * const filter) const;
-	const bool isInFilter(unsigned int year, const YearFilterTuple * const yearsFilter) const;
-	const bool isInFilter(std::string code, std::string engName, std::string cywName, const StringFilterSet * const filter);
-	const bool isSubstringOfArea(const std::string code);
+	const Areas* reference;
+	unsigned int parseThreads;
+	const bool isInFilter(const std::string& code,
+		const std::string& engName,
+		const std::string& cywName,
+		const BethYw::StringFilter& filter,
+		RejectedAreas* rejected = nullptr) const;
+	const bool isSubstringOfArea(const std::string& code) const;
+	const bool keepWelshStatsRow(const WelshStatsRow& row,
+		const unsigned int read,
+		RejectedAreas& rejected,
+		const BethYw::StringFilter& areasFilter,
+		const BethYw::StringFilter& measuresFilter,
+		const BethYw::YearFilter& yearsFilter) const;
+	void addWelshStatsRow(const WelshStatsRow& row,
+		RejectedAreas& rejected,
+		const BethYw::StringFilter& areasFilter,
+		const BethYw::StringFilter& measuresFilter,
+		const BethYw::YearFilter& yearsFilter);
+	void populateFromWelshStatsJSON(
+		const char* data,
+		std::size_t size,
+		const BethYw::SourceColumnMapping& cols,
+		const BethYw::StringFilter& areasFilter,
+		const BethYw::StringFilter& measuresFilter,
+		const BethYw::YearFilter& yearsFilter);
 public:
     Areas();
+	explicit Areas(std::shared_ptr<BethYw::Arena> arena);
+	Areas(const Areas& other) = default;
+	Areas(Areas&& other) = default;
 	~Areas() = default;
-	void setArea(const std::string localAuthorityCode, const Area area);	
-	Area& getArea(const std::string localAuthorityCode);
+	Areas& operator=(const Areas& other) = default;
+	Areas& operator=(Areas&& other) = default;
+	void setArea(const std::string& localAuthorityCode, Area area);
+	Area& upsertArea(const std::string& localAuthorityCode);
+	Area& getArea(const std::string& localAuthorityCode);
+	Area* findArea(const std::string& localAuthorityCode);
+	const Area* findArea(const std::string& localAuthorityCode) const;
 	const int size() const noexcept;
+	void setReference(const Areas* reference) noexcept;
+	void setParseThreads(const unsigned int threads) noexcept;
+	std::shared_ptr<BethYw::Arena> getArena() const noexcept;
+	Areas makePartial() const;
+	void merge(const Areas& other);
+	void merge(Areas&& other);
 	void populateFromAuthorityCodeCSV(
             std::istream& is,
             const BethYw::SourceColumnMapping& cols,
-            const StringFilterSet * const areas = nullptr)
+            const BethYw::StringFilter& areas = BethYw::StringFilter())
             noexcept(false);
 	void populateFromWelshStatsJSON(
     	std::istream& is,
         const BethYw::SourceColumnMapping& cols,
-        const StringFilterSet * const areasFilter = nullptr,
-		const StringFilterSet * const measuresFilter = nullptr,
-		const YearFilterTuple * const yearsFilter = nullptr)
+        const BethYw::StringFilter& areasFilter = BethYw::StringFilter(),
+		const BethYw::StringFilter& measuresFilter = BethYw::StringFilter(),
+		const BethYw::YearFilter& yearsFilter = BethYw::YearFilter())
 		noexcept(false);
 	void populateFromAuthorityByYearCSV(
     	std::istream& is,
         const BethYw::SourceColumnMapping& cols,
-        const StringFilterSet * const areasFilter = nullptr,
-		const StringFilterSet * const measuresFilter = nullptr,
-		const YearFilterTuple * const yearsFilter = nullptr)
+        const BethYw::StringFilter& areasFilter = BethYw::StringFilter(),
+		const BethYw::StringFilter& measuresFilter = BethYw::StringFilter(),
+		const BethYw::YearFilter& yearsFilter = BethYw::YearFilter())
         noexcept(false);
     void populate(
             std::istream& is,
@@ -109,12 +184,43 @@ public:
             std::istream& is,
             const BethYw::SourceDataType& type,
             const BethYw::SourceColumnMapping& cols,
-            const StringFilterSet * const areasFilter = nullptr,
-            const StringFilterSet * const measuresFilter = nullptr,
-            const YearFilterTuple * const yearsFilter = nullptr)
+            const BethYw::StringFilter& areasFilter = BethYw::StringFilter(),
+            const BethYw::StringFilter& measuresFilter = BethYw::StringFilter(),
+            const BethYw::YearFilter& yearsFilter = BethYw::YearFilter())
             noexcept(false);
     std::string toJSON() const;
-	friend std::ostream &operator<<(std::ostream &output, const Areas areas);
+	const BethYw::MemoryUsage getMemoryUsage() const;
+
+	/*
+	    Call fn(area) for every Area, in order of local authority code,
+	    without copying them.
+	*/
+	template <typename Fn>
+	void forEachArea(Fn fn) const {
+#ifdef BETHYW_FLAT_AREAS
+		std::vector<const AreasContainer::value_type*> sorted;
+		sorted.reserve(areas.size());
+		for (auto it = areas.begin(); it != areas.end(); it++) {
+			sorted.push_back(&*it);
+		}
+		BethYw::AuthorityCodeOrder order;
+		std::sort(sorted.begin(), sorted.end(), [&order](
+			const AreasContainer::value_type* lhs,
+			const AreasContainer::value_type* rhs) {
+			return order(lhs->first, rhs->first);
+		});
+		for (auto it = sorted.begin(); it != sorted.end(); it++) {
+			fn((*it)->second);
+		}
+#else
+		for (auto it = areas.begin(); it != areas.end(); it++) {
+			fn(it->second);
+		}
+#endif
+	}
+
+	friend std::ostream &operator<<(std::ostream &output, const Areas& areas);
+	friend class BethYw::Snapshot;
 };
 
 #endif // AREAS_H
@@ -0,0 +1,103 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of Arena, a monotonic memory
+    resource used by the containers of an Areas instance.
+ */
+
+#include <cstdint>
+
+#include "arena.h"
+
+constexpr std::size_t BethYw::Arena::DEFAULT_BLOCK_SIZE;
+
+/*
+    BethYw::Arena::Arena(blockSize)
+
+    Construct an empty Arena. No memory is reserved until the first
+    allocation.
+
+    @param blockSize
+        The size of the blocks memory is handed out from. Allocations larger
+        than a block get a block of their own.
+
+    @example
+        auto arena = std::make_shared<BethYw::Arena>();
+        Areas data(arena);
+*/
+BethYw::Arena::Arena(const std::size_t blockSize)
+	: blockSize(blockSize), blocks(), next(nullptr), end(nullptr), allocated(0), reserved(0) {
+}
+
+/*
+    BethYw::Arena::~Arena()
+
+    Free every block at once.
+*/
+BethYw::Arena::~Arena() {
+	for (auto it = blocks.begin(); it != blocks.end(); it++) {
+		::operator delete(*it);
+	}
+}
+
+/*
+    BethYw::Arena::allocate(bytes, alignment)
+
+    Hand out memory from the current block, starting a new block if it does
+    not fit. The memory is only given back when the Arena is destroyed.
+
+    @param bytes
+        The number of bytes to allocate
+
+    @param alignment
+        The alignment of the memory, at most alignof(std::max_align_t)
+
+    @return
+        A pointer to the memory
+
+    @throws
+        std::bad_alloc if a new block cannot be allocated
+*/
+void* BethYw::Arena::allocate(const std::size_t bytes, const std::size_t alignment) {
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(next);
+	std::uintptr_t aligned = (address + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+	if (next == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end)) {
+		std::size_t size = bytes > blockSize ? bytes : blockSize;
+		blocks.reserve(blocks.size() + 1);
+		char* block = static_cast<char*>(::operator new(size));
+		blocks.push_back(block);
+		reserved += size;
+		allocated += bytes;
+		if (size == blockSize) {
+			next = block + bytes;
+			end = block + size;
+		}
+		return block;
+	}
+	next = reinterpret_cast<char*>(aligned + bytes);
+	allocated += bytes;
+	return reinterpret_cast<void*>(aligned);
+}
+
+/*
+	getAllocated()
+	Returns the number of bytes handed out by the Arena.
+*/
+const std::size_t BethYw::Arena::getAllocated() const noexcept {
+	return allocated;
+}
+
+/*
+	getReserved()
+	Returns the number of bytes in the blocks of the Arena.
+*/
+const std::size_t BethYw::Arena::getReserved() const noexcept {
+	return reserved;
+}
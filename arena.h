@@ -0,0 +1,126 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declarations of Arena, a monotonic memory
+    resource, and ArenaAllocator, a Standard Library allocator that takes its
+    memory from an Arena.
+
+    Importing a dataset makes a very large number of small allocations for
+    the nodes of the maps in Areas, Area and Measure. An Arena hands these out
+    from large blocks by bumping a pointer, and deallocating does nothing:
+    every block is freed at once when the last container using the Arena is
+    destroyed. This makes both importing and tearing down an Areas instance
+    cheaper, at the cost of never reusing memory that has been given back
+    (e.g. when a std::vector grows).
+
+    An ArenaAllocator holds a shared pointer to its Arena, so the Arena lives
+    as long as anything allocated from it. A default constructed
+    ArenaAllocator uses the heap instead. Copying a container gives the copy
+    a heap allocator, so an Arena is only ever used by the containers of the
+    Areas instance it was given to (Arenas are not thread safe).
+ */
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace BethYw {
+
+class Arena {
+public:
+	explicit Arena(const std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+	Arena(const Arena& other) = delete;
+	Arena& operator=(const Arena& other) = delete;
+	~Arena();
+
+	void* allocate(const std::size_t bytes, const std::size_t alignment);
+	const std::size_t getAllocated() const noexcept;
+	const std::size_t getReserved() const noexcept;
+
+	static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+private:
+	std::size_t blockSize;
+	std::vector<void*> blocks;
+	char* next;
+	char* end;
+	std::size_t allocated;
+	std::size_t reserved;
+};
+
+template <typename T>
+class ArenaAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	ArenaAllocator() noexcept : arena() {}
+
+	explicit ArenaAllocator(std::shared_ptr<Arena> arena) noexcept : arena(std::move(arena)) {}
+
+	/*
+	    There is no move constructor, so moving an allocator copies it. A
+	    container that has been moved from keeps using its allocator, and must
+	    still free what it allocated from the same Arena.
+	*/
+	ArenaAllocator(const ArenaAllocator& other) noexcept : arena(other.arena) {}
+	ArenaAllocator& operator=(const ArenaAllocator& other) noexcept = default;
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.getArena()) {}
+
+	T* allocate(const std::size_t n) {
+		if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		if (!arena) {
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		}
+		return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, const std::size_t) noexcept {
+		if (!arena) {
+			::operator delete(p);
+		}
+	}
+
+	/*
+	    Copies of a container are allocated on the heap, see above.
+	*/
+	ArenaAllocator select_on_container_copy_construction() const noexcept {
+		return ArenaAllocator();
+	}
+
+	const std::shared_ptr<Arena>& getArena() const noexcept {
+		return arena;
+	}
+
+private:
+	std::shared_ptr<Arena> arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+	return lhs.getArena() == rhs.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept {
+	return lhs.getArena() != rhs.getArena();
+}
+
+} // namespace BethYw
+
+#endif // ARENA_H_
@@ -0,0 +1,386 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of AuthorityCode, a 32-bit
+    encoding of an ONS area code, and the table of codes that do not follow
+    the standard letter and eight digit structure.
+ */
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "authority.h"
+#include "symbols.h"
+
+namespace {
+
+constexpr unsigned int DIGIT_BITS = 27;
+constexpr std::uint32_t DIGIT_MASK = (std::uint32_t(1) << DIGIT_BITS) - 1;
+
+using FallbackPositions = std::unordered_map<BethYw::Symbol, std::uint32_t, BethYw::SymbolHash>;
+
+/*
+    The codes that are not standard, by their position. Position 0 is the
+    empty string, which is what a default constructed AuthorityCode is.
+
+    A code is never changed once it is added, and the codes are kept in
+    blocks that never move (block b holds FIRST_BLOCK << b codes), so
+    AuthorityCodeOrder can read a code by its position without locking.
+    The mutex is only taken to add a code, or to find the position of one
+    that is not yet in this thread's cache.
+*/
+struct FallbackTable {
+	static constexpr unsigned int FIRST_BLOCK_BITS = 6;
+	static constexpr std::uint32_t FIRST_BLOCK = std::uint32_t(1) << FIRST_BLOCK_BITS;
+	static constexpr unsigned int BLOCKS = DIGIT_BITS - FIRST_BLOCK_BITS + 1;
+
+	std::mutex mutex;
+	std::atomic<BethYw::Symbol*> blocks[BLOCKS];
+	std::uint32_t size;
+	FallbackPositions positions;
+
+	FallbackTable() : mutex(), size(0), positions() {
+		for (unsigned int b = 0; b < BLOCKS; b++) {
+			blocks[b].store(nullptr, std::memory_order_relaxed);
+		}
+		add(BethYw::Symbol());
+	}
+
+	FallbackTable(const FallbackTable&) = delete;
+	FallbackTable& operator=(const FallbackTable&) = delete;
+
+	~FallbackTable() {
+		for (unsigned int b = 0; b < BLOCKS; b++) {
+			delete[] blocks[b].load(std::memory_order_relaxed);
+		}
+	}
+
+	/*
+		Find the block and offset within it of a position.
+	*/
+	static void locate(const std::uint32_t position, unsigned int& block, std::uint32_t& offset) noexcept {
+		const std::uint32_t i = position + FIRST_BLOCK;
+		const unsigned int top = 31 - static_cast<unsigned int>(__builtin_clz(i));
+		block = top - FIRST_BLOCK_BITS;
+		offset = i - (std::uint32_t(1) << top);
+	}
+
+	/*
+		Get the code at a position that has been added. No lock is needed.
+	*/
+	const BethYw::Symbol& at(const std::uint32_t position) const noexcept {
+		unsigned int block;
+		std::uint32_t offset;
+		locate(position, block, offset);
+		return blocks[block].load(std::memory_order_acquire)[offset];
+	}
+
+	/*
+		Add a code at the next position. The mutex must be held.
+	*/
+	std::uint32_t add(const BethYw::Symbol symbol) {
+		unsigned int block;
+		std::uint32_t offset;
+		locate(size, block, offset);
+		BethYw::Symbol* codes = blocks[block].load(std::memory_order_relaxed);
+		if (codes == nullptr) {
+			codes = new BethYw::Symbol[FIRST_BLOCK << block];
+			blocks[block].store(codes, std::memory_order_release);
+		}
+		codes[offset] = symbol;
+		positions.insert(std::make_pair(symbol, size));
+		return size++;
+	}
+
+	/*
+		This thread's copy of the positions it has seen, checked before
+		taking the mutex.
+	*/
+	static FallbackPositions& cache() {
+		thread_local FallbackPositions entries;
+		return entries;
+	}
+};
+
+constexpr unsigned int FallbackTable::FIRST_BLOCK_BITS;
+constexpr std::uint32_t FallbackTable::FIRST_BLOCK;
+constexpr unsigned int FallbackTable::BLOCKS;
+
+FallbackTable& fallbackTable() {
+	static FallbackTable table;
+	return table;
+}
+
+} // namespace
+
+constexpr unsigned int BethYw::AuthorityCode::DIGITS;
+
+/*
+    BethYw::AuthorityCode::AuthorityCode()
+
+    Construct the AuthorityCode for the empty string.
+*/
+BethYw::AuthorityCode::AuthorityCode() noexcept : value(0) {
+}
+
+BethYw::AuthorityCode::AuthorityCode(const std::uint32_t value) noexcept : value(value) {
+}
+
+/*
+    BethYw::AuthorityCode::parseStandard(data, size, value)
+
+    Encode a standard code, i.e. an uppercase letter and eight digits.
+
+    @return
+        true if the code is standard, in which case value is set
+*/
+const bool BethYw::AuthorityCode::parseStandard(const char* data,
+	std::size_t size,
+	std::uint32_t& value) noexcept {
+	if (size != DIGITS + 1 || data[0] < 'A' || data[0] > 'Z') {
+		return false;
+	}
+	std::uint32_t digits = 0;
+	for (std::size_t i = 1; i < size; i++) {
+		if (data[i] < '0' || data[i] > '9') {
+			return false;
+		}
+		digits = digits * 10 + static_cast<std::uint32_t>(data[i] - '0');
+	}
+	value = (static_cast<std::uint32_t>(data[0] - 'A' + 1) << DIGIT_BITS) | digits;
+	return true;
+}
+
+/*
+    BethYw::AuthorityCode::parse(data, size)
+
+    Encode an area code. A code that is not standard is added to the table
+    of fallback codes if it is not already there.
+
+    @param data
+        The characters of the code
+
+    @param size
+        The number of characters
+
+    @return
+        The AuthorityCode
+
+    @throws
+        std::length_error if the table of fallback codes is full
+
+    @example
+        auto code = BethYw::AuthorityCode::parse("W06000001", 9);
+*/
+BethYw::AuthorityCode BethYw::AuthorityCode::parse(const char* data, std::size_t size) {
+	std::uint32_t value;
+	if (parseStandard(data, size, value)) {
+		return AuthorityCode(value);
+	}
+
+	Symbol symbol = intern(data, size);
+	FallbackPositions& cache = FallbackTable::cache();
+	auto cached = cache.find(symbol);
+	if (cached != cache.end()) {
+		return AuthorityCode(cached->second);
+	}
+
+	FallbackTable& table = fallbackTable();
+	std::uint32_t position;
+	{
+		std::lock_guard<std::mutex> lock(table.mutex);
+		auto it = table.positions.find(symbol);
+		if (it != table.positions.end()) {
+			position = it->second;
+		} else if (table.size > DIGIT_MASK) {
+			throw std::length_error("AuthorityCode::parse: Too many non-standard area codes");
+		} else {
+			position = table.add(symbol);
+		}
+	}
+	cache.insert(std::make_pair(symbol, position));
+	return AuthorityCode(position);
+}
+
+/*
+    BethYw::AuthorityCode::parse(code)
+
+    As above, for a std::string.
+*/
+BethYw::AuthorityCode BethYw::AuthorityCode::parse(const std::string& code) {
+	return parse(code.data(), code.size());
+}
+
+/*
+    BethYw::AuthorityCode::find(data, size, code)
+
+    Encode an area code without adding it to the table of fallback codes,
+    for lookups of codes that may not exist.
+
+    @param data
+        The characters of the code
+
+    @param size
+        The number of characters
+
+    @param code
+        Set to the AuthorityCode if the code is standard or in the table
+
+    @return
+        true if code was set
+*/
+const bool BethYw::AuthorityCode::find(const char* data, std::size_t size, AuthorityCode& code) {
+	std::uint32_t value;
+	if (parseStandard(data, size, value)) {
+		code = AuthorityCode(value);
+		return true;
+	}
+
+	Symbol symbol;
+	if (!findSymbol(data, size, symbol)) {
+		return false;
+	}
+	FallbackPositions& cache = FallbackTable::cache();
+	auto cached = cache.find(symbol);
+	if (cached != cache.end()) {
+		code = AuthorityCode(cached->second);
+		return true;
+	}
+
+	FallbackTable& table = fallbackTable();
+	std::uint32_t position;
+	{
+		std::lock_guard<std::mutex> lock(table.mutex);
+		auto it = table.positions.find(symbol);
+		if (it == table.positions.end()) {
+			return false;
+		}
+		position = it->second;
+	}
+	cache.insert(std::make_pair(symbol, position));
+	code = AuthorityCode(position);
+	return true;
+}
+
+/*
+    BethYw::AuthorityCode::find(str, code)
+
+    As above, for a std::string.
+*/
+const bool BethYw::AuthorityCode::find(const std::string& str, AuthorityCode& code) {
+	return find(str.data(), str.size(), code);
+}
+
+/*
+	isStandard()
+	Returns true if the code is an uppercase letter and eight digits.
+*/
+const bool BethYw::AuthorityCode::isStandard() const noexcept {
+	return (value >> DIGIT_BITS) != 0;
+}
+
+/*
+	getValue()
+	Returns the 32-bit encoding of the code.
+*/
+const std::uint32_t BethYw::AuthorityCode::getValue() const noexcept {
+	return value;
+}
+
+/*
+	format(out)
+	Write a standard code in to out, which must have room for DIGITS + 1
+	characters, and return its length.
+*/
+const std::size_t BethYw::AuthorityCode::format(char* out) const noexcept {
+	out[0] = static_cast<char>('A' + (value >> DIGIT_BITS) - 1);
+	std::uint32_t digits = value & DIGIT_MASK;
+	for (std::size_t i = DIGITS; i > 0; i--) {
+		out[i] = static_cast<char>('0' + digits % 10);
+		digits /= 10;
+	}
+	return DIGITS + 1;
+}
+
+/*
+	fallback()
+	Returns the string of a code that is not standard, without locking.
+*/
+const std::string* BethYw::AuthorityCode::fallback() const noexcept {
+	return &fallbackTable().at(value).str();
+}
+
+/*
+    BethYw::AuthorityCode::str()
+
+    @return
+        The area code as a string
+
+    @example
+        auto code = BethYw::AuthorityCode::parse("W06000001");
+        std::cout << code.str(); // W06000001
+*/
+const std::string BethYw::AuthorityCode::str() const {
+	if (!isStandard()) {
+		return *fallback();
+	}
+	char out[DIGITS + 1];
+	return std::string(out, format(out));
+}
+
+bool BethYw::operator==(const AuthorityCode lhs, const AuthorityCode rhs) noexcept {
+	return lhs.value == rhs.value;
+}
+
+bool BethYw::operator!=(const AuthorityCode lhs, const AuthorityCode rhs) noexcept {
+	return lhs.value != rhs.value;
+}
+
+/*
+    BethYw::AuthorityCodeOrder::operator()(lhs, rhs)
+
+    @return
+        true if lhs comes before rhs alphabetically
+*/
+bool BethYw::AuthorityCodeOrder::operator()(const AuthorityCode lhs, const AuthorityCode rhs) const {
+	if (lhs.isStandard() && rhs.isStandard()) {
+		return lhs.value < rhs.value;
+	}
+	if (lhs == rhs) {
+		return false;
+	}
+
+	char lhsOut[AuthorityCode::DIGITS + 1];
+	char rhsOut[AuthorityCode::DIGITS + 1];
+	const char* lhsData = lhsOut;
+	const char* rhsData = rhsOut;
+	std::size_t lhsSize, rhsSize;
+	if (lhs.isStandard()) {
+		lhsSize = lhs.format(lhsOut);
+	} else {
+		const std::string* code = lhs.fallback();
+		lhsData = code->data();
+		lhsSize = code->size();
+	}
+	if (rhs.isStandard()) {
+		rhsSize = rhs.format(rhsOut);
+	} else {
+		const std::string* code = rhs.fallback();
+		rhsData = code->data();
+		rhsSize = code->size();
+	}
+
+	int order = std::memcmp(lhsData, rhsData, lhsSize < rhsSize ? lhsSize : rhsSize);
+	return order < 0 || (order == 0 && lhsSize < rhsSize);
+}
@@ -0,0 +1,84 @@
+#ifndef AUTHORITY_H_
+#define AUTHORITY_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declaration of AuthorityCode, a 32-bit encoding of
+    an ONS (GSS) area code such as W06000001, used as the key of the Areas
+    container.
+
+    A standard code is an uppercase letter followed by eight digits, which
+    fits in 32 bits: the letter takes the top 5 bits (1 for A to 26 for Z)
+    and the digits, as a number, the bottom 27. Comparing two standard codes
+    is then a single integer comparison, and their order as integers is the
+    same as their alphabetical order.
+
+    Any other code (e.g. "AREA1" in tests, or a lowercase code) is kept in a
+    process-wide table and encoded by its position in it, with the top 5 bits
+    zero. Codes are still ordered alphabetically when one is not standard.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace BethYw {
+
+class AuthorityCode {
+public:
+	AuthorityCode() noexcept;
+
+	static AuthorityCode parse(const char* data, std::size_t size);
+	static AuthorityCode parse(const std::string& code);
+	static const bool find(const char* data, std::size_t size, AuthorityCode& code);
+	static const bool find(const std::string& str, AuthorityCode& code);
+
+	const bool isStandard() const noexcept;
+	const std::uint32_t getValue() const noexcept;
+	const std::string str() const;
+
+	friend bool operator==(const AuthorityCode lhs, const AuthorityCode rhs) noexcept;
+	friend bool operator!=(const AuthorityCode lhs, const AuthorityCode rhs) noexcept;
+	friend struct AuthorityCodeOrder;
+
+	static constexpr unsigned int DIGITS = 8;
+
+private:
+	explicit AuthorityCode(const std::uint32_t value) noexcept;
+	std::uint32_t value;
+
+	static const bool parseStandard(const char* data, std::size_t size, std::uint32_t& value) noexcept;
+	const std::size_t format(char* out) const noexcept;
+	const std::string* fallback() const noexcept;
+};
+
+bool operator==(const AuthorityCode lhs, const AuthorityCode rhs) noexcept;
+
+bool operator!=(const AuthorityCode lhs, const AuthorityCode rhs) noexcept;
+
+/*
+    Orders AuthorityCodes alphabetically by their codes, for the Areas
+    container. Two standard codes are compared as integers.
+*/
+struct AuthorityCodeOrder {
+	bool operator()(const AuthorityCode lhs, const AuthorityCode rhs) const;
+};
+
+/*
+    Hashes the encoding of an AuthorityCode, for unordered containers.
+*/
+struct AuthorityCodeHash {
+	std::size_t operator()(const AuthorityCode code) const noexcept {
+		return std::hash<std::uint32_t>()(code.getValue());
+	}
+};
+
+} // namespace BethYw
+
+#endif // AUTHORITY_H_
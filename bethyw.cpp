@@ -22,18 +22,31 @@
     additional functions not specified.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <vector>
 #include <regex>
 #include "lib_cxxopts.hpp"
 
+#include "arena.h"
 #include "areas.h"
 #include "datasets.h"
 #include "bethyw.h"
 #include "input.h"
+#include "numbers.h"
+#include "snapshot.h"
+#include "statswales.h"
 
 /*
     Run Beth Yw?, parsing the command line arguments, importing the data,
@@ -66,15 +79,52 @@ int BethYw::run(int argc, char *argv[]) {
     		auto datasetsToImport = BethYw::parseDatasetsArg(args);
    			auto areasFilter = BethYw::parseAreasArg(args);
     		auto measuresFilter = BethYw::parseMeasuresArg(args);
-   			auto yearsFilter = BethYw::parseYearsArg(args);
+   			auto yearsFilter = BethYw::parseYearsFilterArg(args);
+			bool mapFiles = args.count("mmap") > 0;
+			unsigned int threads = args["threads"].as<unsigned int>();
+			if (threads == 0) {
+				threads = std::thread::hardware_concurrency();
+			}
+
+			// Everything is loaded for a single run, so allocate it all from one
+			// Arena that is released at once when the program exits
+    		Areas data(std::make_shared<BethYw::Arena>());
+			bool loaded = false;
+			std::unique_ptr<Snapshot> snapshot;
+			std::vector<std::string> sources;
+			std::string key;
+			if (args.count("snapshot")) {
+				snapshot.reset(new Snapshot(args["snapshot"].as<std::string>()));
+				sources = BethYw::datasetSourcePaths(dir, datasetsToImport);
+				key = BethYw::snapshotKey(args, dir, datasetsToImport);
+				loaded = snapshot->load(data, key, sources);
+			}
 
-    		Areas data = Areas();
-    		BethYw::loadDatasets(data,
-    			dir,
-    			datasetsToImport,
-   	 			areasFilter,
-    			measuresFilter,
-    			yearsFilter);
+			bool memoryReport = args.count("memory-report") > 0;
+			std::vector<BethYw::MemoryUsage> datasetUsage;
+			if (!loaded) {
+				bool imported = BethYw::loadDatasets(data,
+					dir,
+					datasetsToImport,
+					areasFilter,
+					measuresFilter,
+					yearsFilter,
+					mapFiles,
+					threads,
+					memoryReport ? &datasetUsage : nullptr);
+
+				if (snapshot && imported) {
+					try {
+						snapshot->save(data, key, sources);
+					} catch (const std::runtime_error& e) {
+						std::cerr << e.what() << std::endl;
+					}
+				}
+			}
+
+			if (memoryReport) {
+				BethYw::printMemoryReport(std::cerr, data, datasetsToImport, datasetUsage);
+			}
 
 			if (args.count("json")) {
         		std::cout << data.toJSON() << std::endl;
@@ -129,13 +179,32 @@ cxxopts::Options BethYw::cxxoptsSetup() {
             cxxopts::value<std::vector<std::string>>())(
 
             "y,years",
-            "Focus on a particular year (YYYY) or "
-            "inclusive range of years (YYYY-ZZZZ)",
+            "Focus on a particular year (YYYY), inclusive range of years "
+            "(YYYY-ZZZZ), range open at one end (YYYY- or -ZZZZ), or a "
+            "comma separated list of these (e.g. 1991,2001,2011-)",
             cxxopts::value<std::string>()->default_value("0"))(
 
             "j,json",
             "Print the output as JSON instead of tables.")(
 
+            "mmap",
+            "Read the dataset files through a read-only memory mapping instead "
+            "of a file stream.")(
+
+            "threads",
+            "Number of datasets to import at the same time "
+            "(0 to use one per processor core)",
+            cxxopts::value<unsigned int>()->default_value("1"))(
+
+            "snapshot",
+            "Load the data from this snapshot file if it is up to date, "
+            "otherwise import the datasets and save them to it",
+            cxxopts::value<std::string>())(
+
+            "memory-report",
+            "Print the memory used by areas.csv and each dataset once they "
+            "are imported")(
+
             "h,help",
             "Print usage.");
 
@@ -323,13 +392,13 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(
 		std::regex regIncludeZero("^(0-0)|(0-\\d{4})|(\\d{4}-0)|(0)$");
 
 		if (std::regex_match(inputYears, regTwoYears)) {
-			std::string firstYear = inputYears.substr(0, 4);
-			std::string secondYear = inputYears.substr(5, 4);
-			std::get<0>(years) = std::stoul(firstYear, nullptr);
-			std::get<1>(years) = std::stoul(secondYear, nullptr);
+			const char* chars = inputYears.data();
+			BethYw::parseNumber(chars, chars + 4, std::get<0>(years));
+			BethYw::parseNumber(chars + 5, chars + 9, std::get<1>(years));
 		} else if(std::regex_match(inputYears, regOneYear)) {
-			std::get<0>(years) = std::stoul(inputYears, nullptr);
-			std::get<1>(years) = std::stoul(inputYears, nullptr);
+			const char* chars = inputYears.data();
+			BethYw::parseNumber(chars, chars + 4, std::get<0>(years));
+			std::get<1>(years) = std::get<0>(years);
 		} else if (!std::regex_match(inputYears, regIncludeZero)) {
 			throw std::invalid_argument("Invalid input for years argument");	
 		}
@@ -337,6 +406,349 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(
 	return years;
 }
 
+/*
+    BethYw::parseYearsFilterArg(args)
+
+    Parse the years command line argument in to a YearFilter. As well as the
+    forms accepted by parseYearsArg(), years may be a comma separated list of
+    four digit years (YYYY), inclusive ranges (YYYY-ZZZZ) and ranges open at
+    one end (YYYY- for every year from YYYY, -ZZZZ for every year up to
+    ZZZZ). If any of the years given is 0, or there is no years argument,
+    every year is matched.
+
+    @param args
+        Parsed program arguments
+
+    @return
+        A YearFilter matching every year in the list
+
+    @throws
+        std::invalid_argument if the argument contains an invalid years value with
+        the message: Invalid input for years argument
+
+    @example
+        // --years 1991,2001,2011-2019,2015-
+        auto yearsFilter = BethYw::parseYearsFilterArg(args);
+        yearsFilter.contains(2001); // true
+        yearsFilter.contains(2010); // false
+        yearsFilter.contains(2030); // true
+*/
+BethYw::YearFilter BethYw::parseYearsFilterArg(cxxopts::ParseResult& args) {
+	std::vector<BethYw::YearRange> ranges;
+	if (!args.count("years")) {
+		return BethYw::YearFilter();
+	}
+
+	auto inputYears = args["years"].as<std::string>();
+	std::regex regRange("^(\\d{4}|0)?(-)?(\\d{4}|0)?$");
+	bool all = false;
+	std::size_t start = 0;
+	while (start <= inputYears.size()) {
+		std::size_t end = inputYears.find(',', start);
+		if (end == std::string::npos) {
+			end = inputYears.size();
+		}
+		const std::string item = inputYears.substr(start, end - start);
+		start = end + 1;
+
+		std::smatch match;
+		if (!std::regex_match(item, match, regRange)
+			|| !(match[1].matched || match[3].matched)
+			|| (match[1].matched && match[3].matched && !match[2].matched)) {
+			throw std::invalid_argument("Invalid input for years argument");
+		}
+
+		BethYw::YearRange range(0, BethYw::YearFilter::OPEN);
+		const std::string first = match[1].str();
+		const std::string last = match[3].str();
+		if (match[1].matched) {
+			BethYw::parseNumber(first.data(), first.data() + first.size(), range.first);
+			all = all || range.first == 0;
+		}
+		if (match[3].matched) {
+			BethYw::parseNumber(last.data(), last.data() + last.size(), range.second);
+			all = all || range.second == 0;
+		} else if (!match[2].matched) {
+			range.second = range.first;
+		}
+		ranges.push_back(range);
+	}
+
+	if (all) {
+		return BethYw::YearFilter();
+	}
+	return BethYw::YearFilter(ranges);
+}
+
+/*
+    BethYw::createInputSource(path, mapFiles)
+
+    Create the InputSource for a dataset file. The source is not opened.
+
+    Compressed files are detected by their extension or magic bytes and read
+    through an InputCompressedFile. If there is no file at path, but there is
+    a compressed copy of it (path with .gz or .zst added), that is used
+    instead, so a directory of compressed datasets can be loaded as it is.
+
+    @param path
+        The complete path of the file
+
+    @param mapFiles
+        If true, an uncompressed file is mapped in to memory
+        (InputMappedFile), otherwise it is read through a file stream
+        (InputFile)
+
+    @return
+        A std::unique_ptr to the InputSource
+
+    @example
+        auto input = BethYw::createInputSource("datasets/areas.csv", true);
+        std::istream &is = input->open();
+*/
+std::unique_ptr<InputSource> BethYw::createInputSource(const std::string& path, const bool mapFiles) {
+	const std::string resolved = resolveSourcePath(path);
+	InputCompression compression = detectCompression(resolved);
+	if (compression != NoCompression) {
+		return std::unique_ptr<InputSource>(new InputCompressedFile(resolved, compression));
+	} else if (mapFiles) {
+		return std::unique_ptr<InputSource>(new InputMappedFile(path));
+	}
+	return std::unique_ptr<InputSource>(new InputFile(path));
+}
+
+/*
+    BethYw::pagePath(path, page)
+
+    The path of a later page of a paged dataset. StatsWales returns large
+    datasets in pages, and each page after the first is saved next to the
+    first with its page number before the extension, e.g. popu1009.json,
+    popu1009-2.json, popu1009-3.json, ...
+
+    @param path
+        The path of the first page
+
+    @param page
+        The page number, where 1 is the first page
+
+    @return
+        The path of the page
+
+    @example
+        BethYw::pagePath("datasets/popu1009.json", 2); // "datasets/popu1009-2.json"
+*/
+std::string BethYw::pagePath(const std::string& path, const unsigned int page) {
+	if (page <= 1) {
+		return path;
+	}
+	std::size_t name = path.find_last_of("/\\");
+	std::size_t dot = path.find('.', name == std::string::npos ? 0 : name + 1);
+	if (dot == std::string::npos) {
+		return path + "-" + std::to_string(page);
+	}
+	return path.substr(0, dot) + "-" + std::to_string(page) + path.substr(dot);
+}
+
+/*
+    BethYw::sourceExists(path)
+
+    @param path
+        The path of a dataset file
+
+    @return
+        true if there is a file at path, or a compressed copy of it (see
+        createInputSource())
+*/
+const bool BethYw::sourceExists(const std::string& path) {
+	for (const std::string extension : {"", ".gz", ".zst"}) {
+		if (std::ifstream(path + extension).is_open()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+    BethYw::resolveSourcePath(path)
+
+    @param path
+        The path of a dataset file
+
+    @return
+        path, or the path of its compressed copy if only that exists (see
+        createInputSource())
+*/
+const std::string BethYw::resolveSourcePath(const std::string& path) {
+	if (!std::ifstream(path).is_open()) {
+		for (const std::string extension : {".gz", ".zst"}) {
+			if (std::ifstream(path + extension).is_open()) {
+				return path + extension;
+			}
+		}
+	}
+	return path;
+}
+
+/*
+    BethYw::datasetSourcePaths(dir, datasets)
+
+    List the files that importing datasets from dir reads: areas.csv, each
+    dataset file and any further pages of them (see populateDataset()).
+
+    @param dir
+        Directory of the dataset files, ending with a separator
+
+    @param datasets
+        The datasets to import
+
+    @return
+        The paths of the files, in the order they are read
+*/
+std::vector<std::string> BethYw::datasetSourcePaths(const std::string& dir,
+	const std::vector<InputFileSource>& datasets) {
+	std::vector<std::string> paths;
+	paths.push_back(resolveSourcePath(dir + InputFiles::AREAS.FILE));
+	for (auto& dataset : datasets) {
+		const std::string path = dir + dataset.FILE;
+		paths.push_back(resolveSourcePath(path));
+		if (dataset.PARSER == WelshStatsJSON) {
+			for (unsigned int page = 2; sourceExists(pagePath(path, page)); page++) {
+				paths.push_back(resolveSourcePath(pagePath(path, page)));
+			}
+		}
+	}
+	return paths;
+}
+
+/*
+    BethYw::snapshotKey(args, dir, datasets)
+
+    Describe the arguments that change what is imported, so that a snapshot
+    is only used by runs that would import the same data (see Snapshot).
+
+    @param args
+        Parsed program arguments
+
+    @param dir
+        Directory of the dataset files
+
+    @param datasets
+        The datasets to import
+
+    @return
+        A string describing the arguments
+*/
+const std::string BethYw::snapshotKey(cxxopts::ParseResult& args,
+	const std::string& dir,
+	const std::vector<InputFileSource>& datasets) {
+	auto sorted = [](const std::unordered_set<std::string>& set) {
+		std::vector<std::string> values(set.begin(), set.end());
+		std::sort(values.begin(), values.end());
+		std::string joined;
+		for (auto& value : values) {
+			joined += value + ",";
+		}
+		return joined;
+	};
+
+	std::string key = "dir=" + dir + "\ndatasets=";
+	for (auto& dataset : datasets) {
+		key += dataset.CODE + ",";
+	}
+	key += "\nareas=" + sorted(parseAreasArg(args)) +
+		"\nmeasures=" + sorted(parseMeasuresArg(args)) +
+		"\nyears=" + parseYearsFilterArg(args).str();
+	return key;
+}
+
+/*
+    BethYw::populateDataset(areas, dir, dataset, areasFilter, measuresFilter,
+        yearsFilter, mapFiles)
+
+    Import a single dataset from the directory dir in to areas.
+
+    StatsWales JSON datasets may be split in to pages (see pagePath()). If the
+    first page has an "odata.nextLink" and the next page has been saved, it is
+    imported too, and so on until a page has no link or the next page is
+    missing. Each page is read in to memory on a separate thread while the
+    page before it is parsed.
+
+    Only local page files are followed: the link itself is not fetched.
+
+    @param areas
+        The Areas instance to import in to
+
+    @param dir
+        Directory of the dataset files, ending with a separator
+
+    @param dataset
+        The dataset to import
+
+    @param areasFilter
+        The compiled filter of areas to import, or an empty filter for all
+        areas (see filters.h)
+
+    @param measuresFilter
+        The compiled filter of measures to import, or an empty filter for all
+        measures
+
+    @param yearsFilter
+        The compiled range of years to import, or <0,0> for all years
+
+    @param mapFiles
+        If true, uncompressed files are mapped in to memory
+
+    @throws
+        std::runtime_error or std::out_of_range if a file cannot be opened or
+        parsed
+
+    @example
+        Areas areas;
+        BethYw::populateDataset(areas, "datasets/", BethYw::InputFiles::POPDEN,
+            {}, {}, std::make_tuple(0, 0));
+*/
+void BethYw::populateDataset(Areas& areas,
+	const std::string& dir,
+	const InputFileSource& dataset,
+	const BethYw::StringFilter& areasFilter,
+	const BethYw::StringFilter& measuresFilter,
+	const BethYw::YearFilter& yearsFilter,
+	const bool mapFiles) {
+	const std::string path = dir + dataset.FILE;
+	auto input = BethYw::createInputSource(path, mapFiles);
+	std::istream& is = input->open();
+
+	if (dataset.PARSER != WelshStatsJSON || !sourceExists(pagePath(path, 2))) {
+		areas.populate(is, dataset.PARSER, dataset.COLS, areasFilter, measuresFilter, yearsFilter);
+		return;
+	}
+
+	auto readPage = [mapFiles](const std::string& pagePath) {
+		auto pageInput = BethYw::createInputSource(pagePath, mapFiles);
+		std::istream& pageStream = pageInput->open();
+		return std::string(std::istreambuf_iterator<char>(pageStream), std::istreambuf_iterator<char>());
+	};
+
+	std::string page(std::istreambuf_iterator<char>(is), (std::istreambuf_iterator<char>()));
+	input.reset();
+	for (unsigned int number = 1; ; number++) {
+		std::future<std::string> next;
+		const std::string nextPath = pagePath(path, number + 1);
+		if (!findWelshStatsNextLink(page.data(), page.size()).empty() && sourceExists(nextPath)) {
+			next = std::async(std::launch::async, readPage, nextPath);
+		}
+
+		InputMemoryBuffer buffer;
+		buffer.setView(page.data(), page.size());
+		std::istream pageStream(&buffer);
+		areas.populateFromWelshStatsJSON(pageStream, dataset.COLS, areasFilter, measuresFilter, yearsFilter);
+
+		if (!next.valid()) {
+			break;
+		}
+		page = next.get();
+	}
+}
+
 /*
     TODO: BethYw::loadAreas(areas, dir, areasFilter)
 
@@ -362,7 +774,12 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(
         Directory where the areas.csv file is
 
     @param areasFilter
-        An unordered set of areas to filter, or empty to import all areas
+        The compiled filter of areas to import, or an empty filter to import
+        all areas (see filters.h)
+
+    @param mapFiles
+        If true, read the file through a memory mapping (see
+        BethYw::createInputSource())
 
     @return
         void
@@ -372,11 +789,13 @@ std::tuple<unsigned int, unsigned int> BethYw::parseYearsArg(
 
         BethYw::loadAreas(areas, "data", BethYw::parseAreasArg(args));
 */
-void BethYw::loadAreas(Areas &areas, const std::string dir, const std::unordered_set<std::string> areasFilter) {
+void BethYw::loadAreas(Areas &areas,
+	const std::string dir,
+	const BethYw::StringFilter& areasFilter,
+	const bool mapFiles) {
 	std::string file_dir = dir + InputFiles::AREAS.FILE;
-	InputFile input_file(file_dir);
-	input_file.open();
-	areas.populate(input_file.inStream, InputFiles::AREAS.PARSER , InputFiles::AREAS.COLS , &areasFilter);
+	auto input = BethYw::createInputSource(file_dir, mapFiles);
+	areas.populate(input->open(), InputFiles::AREAS.PARSER , InputFiles::AREAS.COLS , areasFilter);
 }
 /*
     TODO: BethYw::loadDatasets(areas,
@@ -415,11 +834,33 @@ void BethYw::loadAreas(Areas &areas, const std::string dir, const std::unordered
         to filter, or empty to import all measures
 
     @param yearsFilter
-        An two-pair tuple of unsigned ints corresponding to the range of years 
-        to import, which should both be 0 to import all years.
+        The years to import (see BethYw::parseYearsFilterArg()). A two-pair
+        tuple of unsigned ints corresponding to the range of years, which
+        should both be 0 to import all years, is also accepted.
+
+    @param mapFiles
+        If true, read the files through a memory mapping (see
+        BethYw::createInputSource())
+
+    @param threads
+        The number of datasets to parse at the same time. If more than one,
+        each dataset is parsed in to its own Areas instance on a separate
+        thread, and these are then merged in to areas in the order of
+        datasetsToImport, so later datasets still take precedence. When
+        matching the areas filter, each dataset only sees the areas from
+        areas.csv and itself, not those added by the other datasets. Threads
+        not needed for whole datasets are used to split large StatsWales
+        files (see Areas::setParseThreads()).
+
+    @param datasetUsage
+        If not null, the memory added to areas by areas.csv and then by each
+        dataset in turn (see Areas::getMemoryUsage()) is appended to this
+        vector. With more than one thread, this is measured as each dataset
+        is merged in.
 
     @return
-        void
+        true if every dataset was imported, false if there was an error
+        (including running out of memory)
 
     @example
         Areas areas();
@@ -430,29 +871,151 @@ void BethYw::loadAreas(Areas &areas, const std::string dir, const std::unordered
             BethYw::parseDatasetsArgument(args),
             BethYw::parseAreasArg(args),
             BethYw::parseMeasuresArg(args),
-            BethYw::parseYearsArg(args));
+            BethYw::parseYearsFilterArg(args));
 */
-void BethYw::loadDatasets(Areas &areas,
+const bool BethYw::loadDatasets(Areas &areas,
 	std::string dir,
 	std::vector<InputFileSource> datasetsToImport,
 	std::unordered_set<std::string> areasFilter,
 	std::unordered_set<std::string> measuresFilter,
-	std::tuple<unsigned int, unsigned int> yearsFilter) noexcept {	
+	const BethYw::YearFilter& yearsFilter,
+	const bool mapFiles,
+	const unsigned int threads,
+	std::vector<BethYw::MemoryUsage>* datasetUsage) noexcept {	
 	try {
-		BethYw::loadAreas(areas, dir, areasFilter);
-		for (auto it = datasetsToImport.begin(); it != datasetsToImport.end(); it++) {
-			std::string file_dir = dir + it->FILE;
-			InputFile input_file(file_dir);
-			input_file.open();
-			areas.populate(input_file.inStream, it->PARSER , it->COLS , &areasFilter, &measuresFilter, &yearsFilter);
+		BethYw::MemoryUsage before;
+		auto recordUsage = [&areas, &before, datasetUsage]() {
+			if (datasetUsage != nullptr) {
+				BethYw::MemoryUsage after = areas.getMemoryUsage();
+				datasetUsage->push_back(after.since(before));
+				before = after;
+			}
+		};
+
+		// The filters are compiled once, and shared by every dataset and thread
+		const BethYw::StringFilter compiledAreasFilter(areasFilter);
+		const BethYw::StringFilter compiledMeasuresFilter(measuresFilter);
+
+		BethYw::loadAreas(areas, dir, compiledAreasFilter, mapFiles);
+		recordUsage();
+		if (threads <= 1 || datasetsToImport.size() <= 1) {
+			areas.setParseThreads(std::max(threads, 1u));
+			for (auto it = datasetsToImport.begin(); it != datasetsToImport.end(); it++) {
+				BethYw::populateDataset(areas,
+					dir,
+					*it,
+					compiledAreasFilter,
+					compiledMeasuresFilter,
+					yearsFilter,
+					mapFiles);
+				recordUsage();
+			}
+		} else {
+			std::vector<Areas> partials;
+			for (size_t i = 0; i < datasetsToImport.size(); i++) {
+				partials.push_back(areas.makePartial());
+			}
+			std::vector<std::exception_ptr> errors(datasetsToImport.size());
+			std::atomic<size_t> next(0);
+			unsigned int parseThreads = std::max<unsigned int>(threads / datasetsToImport.size(), 1);
+
+			auto worker = [&]() {
+				for (size_t i = next++; i < datasetsToImport.size(); i = next++) {
+					try {
+						const InputFileSource& dataset = datasetsToImport[i];
+						partials[i].setParseThreads(parseThreads);
+						BethYw::populateDataset(partials[i],
+							dir,
+							dataset,
+							compiledAreasFilter,
+							compiledMeasuresFilter,
+							yearsFilter,
+							mapFiles);
+					} catch (...) {
+						errors[i] = std::current_exception();
+					}
+				}
+			};
+
+			std::vector<std::thread> workers;
+			size_t numWorkers = std::min<size_t>(threads, datasetsToImport.size());
+			for (size_t i = 0; i < numWorkers; i++) {
+				workers.push_back(std::thread(worker));
+			}
+			for (auto it = workers.begin(); it != workers.end(); it++) {
+				it->join();
+			}
+
+			for (size_t i = 0; i < partials.size(); i++) {
+				if (errors[i]) {
+					std::rethrow_exception(errors[i]);
+				}
+				areas.merge(std::move(partials[i]));
+				recordUsage();
+			}
 		}
 	} catch (const std::runtime_error& e) {
 		std::cerr << "Error importing dataset:" << std::endl;
 		std::cerr << e.what();
+		return false;
 	} catch (const std::out_of_range& e) {
 		std::cerr << "Error importing dataset:" << std::endl;
 		std::cerr << e.what();
+		return false;
+	} catch (const std::bad_alloc& e) {
+		std::cerr << "Error importing dataset:" << std::endl;
+		std::cerr << "Out of memory";
+		return false;
+	}
+	return true;
+}
+
+/*
+    BethYw::printMemoryReport(output, areas, datasetsToImport, datasetUsage)
+
+    Print a table of the memory used by the imported data: a row for areas.csv
+    and each dataset, as recorded by BethYw::loadDatasets(), and then the total
+    for areas. If the data came from a snapshot, only the total is printed. The
+    Arena the data was allocated from, if any, is printed after the table, as
+    it also holds memory the data no longer uses.
+
+    @param output
+        The stream to print to
+
+    @param areas
+        The imported data
+
+    @param datasetsToImport
+        The datasets passed to BethYw::loadDatasets()
+
+    @param datasetUsage
+        The usage recorded by BethYw::loadDatasets(), or empty
+
+    @example
+        std::vector<BethYw::MemoryUsage> datasetUsage;
+        BethYw::loadDatasets(areas, ..., threads, &datasetUsage);
+        BethYw::printMemoryReport(std::cerr, areas, datasetsToImport, datasetUsage);
+*/
+void BethYw::printMemoryReport(std::ostream& output,
+	const Areas& areas,
+	const std::vector<InputFileSource>& datasetsToImport,
+	const std::vector<BethYw::MemoryUsage>& datasetUsage) {
+	BethYw::printMemoryUsage(output, "", BethYw::MemoryUsage());
+	for (size_t i = 0; i < datasetUsage.size(); i++) {
+		if (i == 0) {
+			BethYw::printMemoryUsage(output, InputFiles::AREAS.FILE, datasetUsage[i]);
+		} else if (i <= datasetsToImport.size()) {
+			BethYw::printMemoryUsage(output, datasetsToImport[i - 1].CODE, datasetUsage[i]);
+		}
+	}
+	BethYw::printMemoryUsage(output, "Total", areas.getMemoryUsage());
+
+	auto arena = areas.getArena();
+	if (arena) {
+		output << "Arena: " << arena->getAllocated() << " bytes allocated, "
+			<< arena->getReserved() << " bytes reserved" << std::endl;
 	}
+	output << std::endl;
 }
 
 /*
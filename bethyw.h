@@ -15,6 +15,7 @@
   functions you need to declare in this file.
  */
 
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <vector>
@@ -23,6 +24,8 @@
 
 #include "datasets.h"
 #include "areas.h"
+#include "input.h"
+#include "memory.h"
 
 const char DIR_SEP =
 #ifdef _WIN32
@@ -69,14 +72,54 @@ std::unordered_set<std::string> parseMeasuresArg(cxxopts::ParseResult& args);
 
 std::tuple<unsigned int, unsigned int> parseYearsArg(cxxopts::ParseResult& args);
 
-void loadAreas(Areas &areas, const std::string dir, const std::unordered_set<std::string> areasFilter);
+/*
+    Parse the years argument, which may also be a list of years and ranges
+    of years, and return a YearFilter matching all of them.
+*/
+BethYw::YearFilter parseYearsFilterArg(cxxopts::ParseResult& args);
+
+std::unique_ptr<InputSource> createInputSource(const std::string& path, const bool mapFiles = false);
+
+std::string pagePath(const std::string& path, const unsigned int page);
+
+const bool sourceExists(const std::string& path);
+
+const std::string resolveSourcePath(const std::string& path);
+
+std::vector<std::string> datasetSourcePaths(const std::string& dir,
+	const std::vector<InputFileSource>& datasets);
+
+const std::string snapshotKey(cxxopts::ParseResult& args,
+	const std::string& dir,
+	const std::vector<InputFileSource>& datasets);
+
+void populateDataset(Areas& areas,
+	const std::string& dir,
+	const InputFileSource& dataset,
+	const BethYw::StringFilter& areasFilter,
+	const BethYw::StringFilter& measuresFilter,
+	const BethYw::YearFilter& yearsFilter,
+	const bool mapFiles = false);
+
+void loadAreas(Areas &areas,
+	const std::string dir,
+	const BethYw::StringFilter& areasFilter,
+	const bool mapFiles = false);
 
-void loadDatasets(Areas &areas,
+const bool loadDatasets(Areas &areas,
 	std::string dir,
 	std::vector<InputFileSource> datasetsToImport,
 	std::unordered_set<std::string> areasFilter,
 	std::unordered_set<std::string> measuresFilter,
-	std::tuple<unsigned int, unsigned int> yearsfilter) noexcept;
+	const BethYw::YearFilter& yearsFilter,
+	const bool mapFiles = false,
+	const unsigned int threads = 1,
+	std::vector<BethYw::MemoryUsage>* datasetUsage = nullptr) noexcept;
+
+void printMemoryReport(std::ostream& output,
+	const Areas& areas,
+	const std::vector<InputFileSource>& datasetsToImport,
+	const std::vector<BethYw::MemoryUsage>& datasetUsage);
 
 const bool isAllInVectorOfStrings(const std::vector<std::string> vec);
 
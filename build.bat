@@ -2,9 +2,15 @@
 
 SET bin_dir=bin
 SET tests_dir=tests
-SET source_files=bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp
+SET source_files=bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp statswales.cpp csv.cpp scan.cpp numbers.cpp snapshot.cpp symbols.cpp arena.cpp facts.cpp authority.cpp memory.cpp filters.cpp
 SET main_file=main.cpp
 SET executable=%bin_dir%\bethyw.exe
+SET extra_flags=
+REM zlib is needed for .gz datasets, for .zst datasets also add
+REM -DBETHYW_HAVE_ZSTD to extra_flags and -lzstd to libs
+SET libs=-lz
+REM For datasets with very many areas, add -DBETHYW_FLAT_AREAS to extra_flags to
+REM import areas in to a hash table instead of a std::map (see areas.h)
 
 COPY bin\bethyw2.exe bin\bethyw.exe
 
@@ -21,10 +27,17 @@ IF %testStr%==test (
      g++ --std=c++11 -c lib_catch_main.cpp -o %bin_dir%\catch.o
   )
 )
+SET benchStr=%1%
+SET benchStr=%benchStr:~0,5%
+IF %benchStr%==bench (
+  SET main_file=%tests_dir%\%1%.cpp
+  SET executable=%bin_dir%\bethyw-bench.exe
+  SET extra_flags=-O2
+)
 
 :compile
 IF NOT EXIST %bin_dir% MKDIR %bin_dir%
 IF EXIST %executable% DEL %executable%
-g++ --std=c++14 -Wall %source_files% %main_file% -o %executable%
+g++ --std=c++14 -Wall -pthread %extra_flags% %source_files% %main_file% -o %executable% %libs%
 
 :end
@@ -2,15 +2,21 @@
 
 BIN_DIR="bin"
 TESTS_DIR="tests"
-SOURCE_FILES="bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp"
+SOURCE_FILES="bethyw.cpp input.cpp areas.cpp area.cpp measure.cpp statswales.cpp csv.cpp scan.cpp numbers.cpp snapshot.cpp symbols.cpp arena.cpp facts.cpp authority.cpp memory.cpp filters.cpp"
 MAIN_FILE="main.cpp"
 EXECUTABLE="./${BIN_DIR}/bethyw"
+EXTRA_FLAGS=""
+# zlib is needed for .gz datasets, for .zst datasets also add
+# -DBETHYW_HAVE_ZSTD to EXTRA_FLAGS and -lzstd to LIBS
+LIBS="-lz"
+# For datasets with very many areas, add -DBETHYW_FLAT_AREAS to EXTRA_FLAGS to
+# import areas in to a hash table instead of a std::map (see areas.h)
 
 set -x
 cd "${0%/*}"
 
 if [ $# -gt 1 ]; then
-  echo "Unknown arguments!" "Only one argument accepted, and must begin with test"
+  echo "Unknown arguments!" "Only one argument accepted, and must begin with test or bench"
   exit
 elif [ $# -eq 1 ]; then
   if [[ $1 == test* ]]; then
@@ -22,9 +28,14 @@ elif [ $# -eq 1 ]; then
     if [ ! -f ./${BIN_DIR}/catch.o ]; then
       g++ --std=c++11 -c ./lib_catch_main.cpp -o ./${BIN_DIR}/catch.o
     fi
+  elif [[ $1 == bench* ]]; then
+    # Benchmarks have their own main() and are timed with optimisation on
+    MAIN_FILE="./${TESTS_DIR}/$1.cpp"
+    EXECUTABLE="./${BIN_DIR}/bethyw-bench"
+    EXTRA_FLAGS="-O2"
   fi
 fi
 
 mkdir -p ${BIN_DIR}
 rm ${EXECUTABLE} 2> /dev/null
-g++ --std=c++14 -pedantic -Wall ${SOURCE_FILES} ${MAIN_FILE} -o ${EXECUTABLE}
\ No newline at end of file
+g++ --std=c++14 -pedantic -Wall -pthread ${EXTRA_FLAGS} ${SOURCE_FILES} ${MAIN_FILE} -o ${EXECUTABLE} ${LIBS}
\ No newline at end of file
@@ -0,0 +1,247 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of the CsvReader class. The stream
+    is read in chunks in to a single buffer. A record is only split in to
+    fields once the whole record (up to an unquoted line break) is in the
+    buffer, so that quoted fields can be unescaped in place.
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "csv.h"
+#include "scan.h"
+
+namespace {
+
+/*
+    The bytes the reader searches for: a quote or line break when looking for
+    the end of a record, a quote inside quotes, and a delimiter in a field.
+*/
+const BethYw::ByteSet RECORD_BYTES("\"\n");
+const BethYw::ByteSet QUOTE("\"");
+const BethYw::ByteSet DELIMITER(",");
+
+} // namespace
+
+/*
+	CsvField::empty()
+	Returns true if the field has no characters.
+*/
+const bool CsvField::empty() const noexcept {
+	return size == 0;
+}
+
+/*
+	CsvField::str()
+	Returns a copy of the field as a std::string.
+*/
+std::string CsvField::str() const {
+	return std::string(data, size);
+}
+
+/*
+	operator==(lhs, rhs)
+	Compares a field to a std::string without copying the field.
+*/
+bool operator==(const CsvField& lhs, const std::string& rhs) noexcept {
+	return lhs.size == rhs.size() &&
+		(lhs.size == 0 || std::memcmp(lhs.data, rhs.data(), lhs.size) == 0);
+}
+
+bool operator!=(const CsvField& lhs, const std::string& rhs) noexcept {
+	return !(lhs == rhs);
+}
+
+/*
+    CsvReader::CsvReader(is, chunkSize)
+
+    Construct a reader for a CSV stream. Nothing is read until readRecord() is
+    called.
+
+    @param is
+        The input stream from InputSource
+
+    @param chunkSize
+        The number of bytes to read from the stream at a time. The buffer grows
+        if a single record is larger than this.
+
+    @example
+        CsvReader reader(is);
+*/
+CsvReader::CsvReader(std::istream& is, const std::size_t chunkSize)
+	: is(is), buffer(std::max<std::size_t>(chunkSize, 1)), start(0), end(0),
+	eof(false), record() {
+}
+
+/*
+    CsvReader::readRecord()
+
+    Read the next record from the stream and split it in to fields, which can
+    then be retrieved with fields().
+
+    @return
+        true if a record was read, false at the end of the stream
+*/
+bool CsvReader::readRecord() {
+	bool inQuotes = false;
+	std::size_t scanned = 0;
+
+	while (true) {
+		std::size_t pos = findRecordEnd(start + scanned, inQuotes);
+		if (pos < end) {
+			std::size_t from = start;
+			start = pos + 1;
+			splitRecord(from, pos);
+			if (!record.empty()) {
+				return true;
+			}
+			inQuotes = false;
+			scanned = 0;
+			continue;
+		}
+
+		scanned = pos - start;
+		if (!fill()) {
+			if (start == end) {
+				record.clear();
+				return false;
+			}
+			std::size_t from = start;
+			start = end;
+			splitRecord(from, end);
+			if (!record.empty()) {
+				return true;
+			}
+		}
+	}
+}
+
+/*
+	fields()
+	Returns the fields of the last record read by readRecord().
+*/
+const std::vector<CsvField>& CsvReader::fields() const noexcept {
+	return record;
+}
+
+/*
+	fill()
+	Move any unread data to the front of the buffer and read more from the
+	stream after it, growing the buffer if it is full. Returns false if there
+	was nothing left to read.
+*/
+bool CsvReader::fill() {
+	if (eof) {
+		return false;
+	}
+
+	if (start > 0) {
+		std::copy(buffer.begin() + start, buffer.begin() + end, buffer.begin());
+		end -= start;
+		start = 0;
+	}
+	if (end == buffer.size()) {
+		buffer.resize(buffer.size() * 2);
+	}
+
+	is.read(buffer.data() + end, buffer.size() - end);
+	std::size_t count = static_cast<std::size_t>(is.gcount());
+	end += count;
+	if (count == 0) {
+		eof = true;
+	}
+	return count > 0;
+}
+
+/*
+	findRecordEnd(from, inQuotes)
+	Find the next line break that is not inside quotes, starting at from.
+	inQuotes carries the quote state between calls when a record is split
+	across reads. Returns end if there is no line break in the buffer.
+*/
+const std::size_t CsvReader::findRecordEnd(std::size_t from, bool& inQuotes) const noexcept {
+	const char* chars = buffer.data();
+	while (from < end) {
+		const char* p = BethYw::findFirstOf(chars + from, chars + end, inQuotes ? QUOTE : RECORD_BYTES);
+		from = p - chars;
+		if (from == end) {
+			break;
+		}
+		if (*p == '"') {
+			inQuotes = !inQuotes;
+		} else {
+			return from;
+		}
+		from++;
+	}
+	return end;
+}
+
+/*
+	splitRecord(from, to)
+	Split the characters in buffer[from, to) in to fields. A trailing carriage
+	return is dropped, as is a trailing delimiter (so "a,b," is two fields),
+	and quoted fields are unescaped in place.
+*/
+void CsvReader::splitRecord(std::size_t from, std::size_t to) {
+	record.clear();
+	if (to > from && buffer[to - 1] == '\r') {
+		to--;
+	}
+	if (from == to) {
+		return;
+	}
+
+	char* chars = buffer.data();
+	std::size_t i = from;
+	while (true) {
+		std::size_t fieldStart = i;
+		std::size_t fieldEnd;
+		if (i < to && chars[i] == '"') {
+			std::size_t out = i;
+			i++;
+			while (i < to) {
+				if (chars[i] == '"') {
+					if (i + 1 < to && chars[i + 1] == '"') {
+						chars[out++] = '"';
+						i += 2;
+					} else {
+						i++;
+						break;
+					}
+				} else {
+					chars[out++] = chars[i++];
+				}
+			}
+			while (i < to && chars[i] != ',') {
+				chars[out++] = chars[i++];
+			}
+			fieldEnd = out;
+		} else {
+			i = BethYw::findFirstOf(chars + i, chars + to, DELIMITER) - chars;
+			fieldEnd = i;
+		}
+
+		record.push_back(CsvField{chars + fieldStart, fieldEnd - fieldStart});
+		if (i >= to) {
+			break;
+		}
+
+		// A delimiter at the end of the record does not start another field,
+		// as with the std::getline() splitting this replaced
+		i++;
+		if (i == to) {
+			break;
+		}
+	}
+}
@@ -0,0 +1,78 @@
+#ifndef CSV_H_
+#define CSV_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declaration of the CsvReader class, which splits a
+    comma-separated values (CSV) stream in to records and fields.
+
+    Rather than copying every field in to its own std::string, the stream is
+    read in large chunks in to a buffer that is reused for the whole file, and
+    each field is handed out as a CsvField that points in to that buffer.
+ */
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+/*
+    A single field of a CSV record. This does not own its characters: it
+    points in to the buffer of the CsvReader that produced it, and is only
+    valid until the next call to CsvReader::readRecord().
+*/
+struct CsvField {
+	const char* data;
+	std::size_t size;
+
+	const bool empty() const noexcept;
+	std::string str() const;
+};
+
+bool operator==(const CsvField& lhs, const std::string& rhs) noexcept;
+bool operator!=(const CsvField& lhs, const std::string& rhs) noexcept;
+
+/*
+    Reads CSV records from a stream one at a time. Fields may be quoted with
+    double quotes, in which case they can contain commas, line breaks and
+    escaped quotes (""). Records can end with either LF or CRLF, and blank
+    lines are skipped. A delimiter at the end of a record is ignored, so
+    "a,b," has two fields, not three with an empty last one.
+
+    @example
+        CsvReader reader(is);
+        while (reader.readRecord()) {
+            for (auto& field : reader.fields()) {
+                // do stuff here...
+            }
+        }
+*/
+class CsvReader {
+public:
+	CsvReader(std::istream& is, const std::size_t chunkSize = 64 * 1024);
+	~CsvReader() = default;
+	CsvReader(const CsvReader&) = delete;
+	CsvReader& operator=(const CsvReader&) = delete;
+
+	bool readRecord();
+	const std::vector<CsvField>& fields() const noexcept;
+
+private:
+	std::istream& is;
+	std::vector<char> buffer;
+	std::size_t start;
+	std::size_t end;
+	bool eof;
+	std::vector<CsvField> record;
+
+	bool fill();
+	const std::size_t findRecordEnd(std::size_t from, bool& inQuotes) const noexcept;
+	void splitRecord(std::size_t from, std::size_t to);
+};
+
+#endif // CSV_H_
@@ -0,0 +1,284 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of FactTable, a column-oriented
+    copy of the readings in an Areas instance.
+ */
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "facts.h"
+
+/*
+    BethYw::FactTable::FactTable()
+
+    Construct an empty FactTable.
+*/
+BethYw::FactTable::FactTable()
+	: areaCodes(), measureCodenames(), areaLookup(), measureLookup(),
+	areaIds(), measureIds(), years(), values() {
+}
+
+/*
+    BethYw::FactTable::FactTable(areas)
+
+    Construct a FactTable holding every reading in an Areas instance. Later
+    changes to areas are not reflected in the FactTable.
+
+    @param areas
+        The populated Areas instance
+
+    @example
+        Areas data = Areas();
+        ...
+        BethYw::FactTable facts(data);
+        std::uint32_t pop;
+        if (facts.findMeasure("pop", pop)) {
+          double total = facts.sum(pop, 2015, 2015);
+        }
+*/
+BethYw::FactTable::FactTable(const Areas& areas) : FactTable() {
+	std::set<Symbol, SymbolOrder> codenames;
+	std::size_t rows = 0;
+	areas.forEachArea([&](const Area& area) {
+		areaLookup.insert(std::make_pair(AuthorityCode::parse(area.getLocalAuthorityCode()), areaCodes.size()));
+		areaCodes.push_back(intern(area.getLocalAuthorityCode()));
+		area.forEachMeasure([&](const std::string& codename, const Measure& measure) {
+			codenames.insert(intern(codename));
+			rows += measure.size();
+		});
+	});
+	for (auto it = codenames.begin(); it != codenames.end(); it++) {
+		measureLookup.insert(std::make_pair(*it, measureCodenames.size()));
+		measureCodenames.push_back(*it);
+	}
+
+	areaIds.reserve(rows);
+	measureIds.reserve(rows);
+	years.reserve(rows);
+	values.reserve(rows);
+	std::uint32_t areaId = 0;
+	areas.forEachArea([&](const Area& area) {
+		area.forEachMeasure([&](const std::string& codename, const Measure& measure) {
+			const std::uint32_t measureId = measureLookup.at(intern(codename));
+			measure.forEachValue([&](const unsigned int year, const double value) {
+				areaIds.push_back(areaId);
+				measureIds.push_back(measureId);
+				years.push_back(year);
+				values.push_back(value);
+			});
+		});
+		areaId++;
+	});
+}
+
+/*
+	size()
+	Returns the number of readings (rows).
+*/
+const std::size_t BethYw::FactTable::size() const noexcept {
+	return values.size();
+}
+
+/*
+	numAreas()
+	Returns the number of area codes in the dictionary.
+*/
+const std::size_t BethYw::FactTable::numAreas() const noexcept {
+	return areaCodes.size();
+}
+
+/*
+	numMeasures()
+	Returns the number of measure codenames in the dictionary.
+*/
+const std::size_t BethYw::FactTable::numMeasures() const noexcept {
+	return measureCodenames.size();
+}
+
+/*
+    BethYw::FactTable::findArea(localAuthorityCode, id)
+
+    Find the id of an area code.
+
+    @param localAuthorityCode
+        The local authority code
+
+    @param id
+        Set to the id of the area if it is found
+
+    @return
+        true if there is an area with the code
+*/
+const bool BethYw::FactTable::findArea(const std::string& localAuthorityCode, std::uint32_t& id) const {
+	AuthorityCode code;
+	if (!AuthorityCode::find(localAuthorityCode, code)) {
+		return false;
+	}
+	auto it = areaLookup.find(code);
+	if (it == areaLookup.end()) {
+		return false;
+	}
+	id = it->second;
+	return true;
+}
+
+/*
+    BethYw::FactTable::findMeasure(codename, id)
+
+    Find the id of a measure codename.
+
+    @param codename
+        The measure codename, which is case insensitive
+
+    @param id
+        Set to the id of the measure if it is found
+
+    @return
+        true if there is a measure with the codename
+*/
+const bool BethYw::FactTable::findMeasure(const std::string& codename, std::uint32_t& id) const {
+	Symbol symbol;
+	if (!findLowercaseSymbol(codename, symbol)) {
+		return false;
+	}
+	auto it = measureLookup.find(symbol);
+	if (it == measureLookup.end()) {
+		return false;
+	}
+	id = it->second;
+	return true;
+}
+
+/*
+    BethYw::FactTable::getAreaCode(id)
+
+    @param id
+        An area id
+
+    @return
+        The local authority code of the area
+
+    @throws
+        std::out_of_range if there is no area with the id
+*/
+const std::string& BethYw::FactTable::getAreaCode(const std::uint32_t id) const {
+	if (id >= areaCodes.size()) {
+		throw std::out_of_range("FactTable::getAreaCode: No area with id " + std::to_string(id));
+	}
+	return areaCodes[id].str();
+}
+
+/*
+    BethYw::FactTable::getMeasureCodename(id)
+
+    @param id
+        A measure id
+
+    @return
+        The codename of the measure
+
+    @throws
+        std::out_of_range if there is no measure with the id
+*/
+const std::string& BethYw::FactTable::getMeasureCodename(const std::uint32_t id) const {
+	if (id >= measureCodenames.size()) {
+		throw std::out_of_range("FactTable::getMeasureCodename: No measure with id " + std::to_string(id));
+	}
+	return measureCodenames[id].str();
+}
+
+/*
+	getAreaIds()
+	Returns the area id column.
+*/
+const std::vector<std::uint32_t>& BethYw::FactTable::getAreaIds() const noexcept {
+	return areaIds;
+}
+
+/*
+	getMeasureIds()
+	Returns the measure id column.
+*/
+const std::vector<std::uint32_t>& BethYw::FactTable::getMeasureIds() const noexcept {
+	return measureIds;
+}
+
+/*
+	getYears()
+	Returns the year column.
+*/
+const std::vector<unsigned int>& BethYw::FactTable::getYears() const noexcept {
+	return years;
+}
+
+/*
+	getValues()
+	Returns the value column.
+*/
+const std::vector<double>& BethYw::FactTable::getValues() const noexcept {
+	return values;
+}
+
+/*
+    BethYw::FactTable::count(measureId, firstYear, lastYear)
+
+    @return
+        The number of readings of a measure between two years inclusive,
+        across every area
+*/
+const std::size_t BethYw::FactTable::count(const std::uint32_t measureId,
+	const unsigned int firstYear,
+	const unsigned int lastYear) const noexcept {
+	std::size_t total = 0;
+	forEachFact(measureId, firstYear, lastYear, [&total](const std::uint32_t, const unsigned int, const double) {
+		total++;
+	});
+	return total;
+}
+
+/*
+    BethYw::FactTable::sum(measureId, firstYear, lastYear)
+
+    @return
+        The sum of the readings of a measure between two years inclusive,
+        across every area
+*/
+const double BethYw::FactTable::sum(const std::uint32_t measureId,
+	const unsigned int firstYear,
+	const unsigned int lastYear) const noexcept {
+	double total = 0;
+	forEachFact(measureId, firstYear, lastYear, [&total](const std::uint32_t, const unsigned int, const double value) {
+		total += value;
+	});
+	return total;
+}
+
+/*
+    BethYw::FactTable::average(measureId, firstYear, lastYear)
+
+    @return
+        The mean of the readings of a measure between two years inclusive,
+        across every area, or 0 if there are none (as Measure::getAverage())
+*/
+const double BethYw::FactTable::average(const std::uint32_t measureId,
+	const unsigned int firstYear,
+	const unsigned int lastYear) const noexcept {
+	double total = 0;
+	std::size_t readings = 0;
+	forEachFact(measureId, firstYear, lastYear, [&](const std::uint32_t, const unsigned int, const double value) {
+		total += value;
+		readings++;
+	});
+	return readings ? total / readings : 0;
+}
@@ -0,0 +1,105 @@
+#ifndef FACTS_H_
+#define FACTS_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declaration of FactTable, a column-oriented copy
+    of the readings in an Areas instance for analytical scans.
+
+    Areas stores its readings in maps of Areas, of Measures, of years, which
+    suits looking up one Area or Measure, but a question about every Area at
+    once (e.g. the total population in 2015) must visit every node. A
+    FactTable holds each reading as a row of (area id, measure id, year,
+    value) in four contiguous arrays, so the same question is a single loop.
+
+    The ids index two arrays of the area codes and measure codenames, in
+    alphabetical order, so rows are in the same order as Areas outputs them:
+    by area, then measure, then year. Codes are turned back in to ids with
+    two hash tables (unordered_maps).
+
+    A FactTable is built from an Areas instance once it has been populated.
+    Areas remains the primary storage, as getArea() and getMeasure() hand
+    out references that a FactTable cannot provide.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "areas.h"
+#include "authority.h"
+#include "symbols.h"
+
+namespace BethYw {
+
+class FactTable {
+public:
+	FactTable();
+	explicit FactTable(const Areas& areas);
+	~FactTable() = default;
+
+	const std::size_t size() const noexcept;
+	const std::size_t numAreas() const noexcept;
+	const std::size_t numMeasures() const noexcept;
+
+	const bool findArea(const std::string& localAuthorityCode, std::uint32_t& id) const;
+	const bool findMeasure(const std::string& codename, std::uint32_t& id) const;
+	const std::string& getAreaCode(const std::uint32_t id) const;
+	const std::string& getMeasureCodename(const std::uint32_t id) const;
+
+	const std::vector<std::uint32_t>& getAreaIds() const noexcept;
+	const std::vector<std::uint32_t>& getMeasureIds() const noexcept;
+	const std::vector<unsigned int>& getYears() const noexcept;
+	const std::vector<double>& getValues() const noexcept;
+
+	const std::size_t count(const std::uint32_t measureId,
+		const unsigned int firstYear,
+		const unsigned int lastYear) const noexcept;
+	const double sum(const std::uint32_t measureId,
+		const unsigned int firstYear,
+		const unsigned int lastYear) const noexcept;
+	const double average(const std::uint32_t measureId,
+		const unsigned int firstYear,
+		const unsigned int lastYear) const noexcept;
+
+	/*
+	    Call fn(areaId, year, value) for every reading of a measure between
+	    two years inclusive, in row order.
+	*/
+	template <typename Fn>
+	void forEachFact(const std::uint32_t measureId,
+		const unsigned int firstYear,
+		const unsigned int lastYear,
+		Fn fn) const {
+		const std::size_t rows = values.size();
+		const std::uint32_t* measureColumn = measureIds.data();
+		const unsigned int* yearColumn = years.data();
+		for (std::size_t i = 0; i < rows; i++) {
+			if (measureColumn[i] == measureId && yearColumn[i] >= firstYear && yearColumn[i] <= lastYear) {
+				fn(areaIds[i], yearColumn[i], values[i]);
+			}
+		}
+	}
+
+private:
+	std::vector<Symbol> areaCodes;
+	std::vector<Symbol> measureCodenames;
+	std::unordered_map<AuthorityCode, std::uint32_t, AuthorityCodeHash> areaLookup;
+	std::unordered_map<Symbol, std::uint32_t, SymbolHash> measureLookup;
+
+	std::vector<std::uint32_t> areaIds;
+	std::vector<std::uint32_t> measureIds;
+	std::vector<unsigned int> years;
+	std::vector<double> values;
+};
+
+} // namespace BethYw
+
+#endif // FACTS_H_
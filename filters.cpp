@@ -0,0 +1,392 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of the StringFilter and YearFilter
+    classes, see filters.h.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <queue>
+
+#include "filters.h"
+
+namespace {
+
+/*
+	Convert an ASCII letter to lowercase, as BethYw::toLowercase() does.
+*/
+char lower(const char c) noexcept {
+	return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c;
+}
+
+} // namespace
+
+/*
+    BethYw::StringFilter::StringFilter()
+
+    Construct a filter that matches everything.
+*/
+BethYw::StringFilter::StringFilter() : keys(), classCount(0), transitions(), accepting() {
+	compile();
+}
+
+/*
+    BethYw::StringFilter::StringFilter(values)
+
+    Compile a set of strings in to a filter.
+
+    @param values
+        The strings to match, or an empty set to match everything
+
+    @example
+        BethYw::StringFilter measuresFilter(BethYw::parseMeasuresArg(args));
+        measuresFilter.contains("POP");
+*/
+BethYw::StringFilter::StringFilter(const std::unordered_set<std::string>& values)
+	: keys(values.size()), classCount(0), transitions(), accepting() {
+	for (auto it = values.begin(); it != values.end(); it++) {
+		std::string key(*it);
+		std::transform(key.begin(), key.end(), key.begin(), lower);
+		keys.insert(std::move(key));
+	}
+	compile();
+}
+
+/*
+    BethYw::StringFilter::StringFilter(values)
+
+    Compile a set of strings in to a filter, as above, or construct a filter
+    that matches everything if values is null.
+*/
+BethYw::StringFilter::StringFilter(const std::unordered_set<std::string>* values)
+	: StringFilter(values != nullptr ? StringFilter(*values) : StringFilter()) {
+}
+
+/*
+	matchesAll()
+	Returns true if the filter matches every value.
+*/
+const bool BethYw::StringFilter::matchesAll() const noexcept {
+	return keys.empty();
+}
+
+/*
+    BethYw::StringFilter::contains(value)
+
+    Check if a value is one of the strings in the filter, ignoring case.
+
+    @param value
+        The value to look up
+
+    @return
+        true if the value is in the filter, or the filter matches everything
+*/
+const bool BethYw::StringFilter::contains(const std::string& value) const {
+	return matchesAll() || keys.count(value) > 0;
+}
+
+/*
+    BethYw::StringFilter::containsPartOf(value)
+
+    Check if any of the strings in the filter appears in a value, ignoring
+    case, e.g. the areas filter "swan" matches the area name "Swansea". This
+    stops at the first string that matches.
+
+    @param value
+        The value to search, an empty value is never matched
+
+    @return
+        true if a string in the filter appears in the value, or the filter
+        matches everything
+*/
+const bool BethYw::StringFilter::containsPartOf(const std::string& value) const noexcept {
+	if (matchesAll()) {
+		return true;
+	}
+	std::uint32_t state = 0;
+	for (auto it = value.begin(); it != value.end(); it++) {
+		state = transitions[state * classCount + byteClass[static_cast<unsigned char>(*it)]];
+		if (accepting[state]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+	size()
+	Returns the number of distinct strings in the filter.
+*/
+const std::size_t BethYw::StringFilter::size() const noexcept {
+	return keys.size();
+}
+
+/*
+    BethYw::StringFilter::compile()
+
+    Build the Aho-Corasick automaton for containsPartOf() from the keys.
+
+    The keys are first added to a trie. Then, in breadth-first order, each
+    state is given a failure link to the state for the longest proper suffix
+    of its string that is also in the trie, and every missing transition is
+    filled in by following the failure links. The result never needs to
+    backtrack: each byte of a value is one table lookup.
+*/
+void BethYw::StringFilter::compile() {
+	const std::uint32_t none = UINT32_MAX;
+
+	std::fill(std::begin(byteClass), std::end(byteClass), 0);
+	classCount = 1;
+	for (auto key = keys.begin(); key != keys.end(); key++) {
+		for (auto it = key->begin(); it != key->end(); it++) {
+			const unsigned char c = static_cast<unsigned char>(*it);
+			if (byteClass[c] == 0) {
+				byteClass[c] = static_cast<std::uint16_t>(classCount++);
+				if (c >= 'a' && c <= 'z') {
+					byteClass[c - 32] = byteClass[c];
+				}
+			}
+		}
+	}
+
+	transitions.assign(classCount, none);
+	accepting.assign(1, 0);
+	for (auto key = keys.begin(); key != keys.end(); key++) {
+		std::uint32_t state = 0;
+		for (auto it = key->begin(); it != key->end(); it++) {
+			std::size_t next = state * classCount + byteClass[static_cast<unsigned char>(*it)];
+			if (transitions[next] == none) {
+				transitions[next] = static_cast<std::uint32_t>(accepting.size());
+				transitions.resize(transitions.size() + classCount, none);
+				accepting.push_back(0);
+			}
+			state = transitions[next];
+		}
+		accepting[state] = 1;
+	}
+
+	std::vector<std::uint32_t> failure(accepting.size(), 0);
+	std::queue<std::uint32_t> queue;
+	for (std::size_t c = 0; c < classCount; c++) {
+		if (transitions[c] == none) {
+			transitions[c] = 0;
+		} else {
+			queue.push(transitions[c]);
+		}
+	}
+	while (!queue.empty()) {
+		const std::uint32_t state = queue.front();
+		queue.pop();
+		if (accepting[failure[state]]) {
+			accepting[state] = 1;
+		}
+		for (std::size_t c = 0; c < classCount; c++) {
+			std::uint32_t& next = transitions[state * classCount + c];
+			const std::uint32_t fallback = transitions[failure[state] * classCount + c];
+			if (next == none) {
+				next = fallback;
+			} else {
+				failure[next] = fallback;
+				queue.push(next);
+			}
+		}
+	}
+}
+
+/*
+	CaseInsensitiveHash(str)
+	FNV-1a hash of the characters of str converted to lowercase.
+*/
+std::size_t BethYw::StringFilter::CaseInsensitiveHash::operator()(const std::string& str) const noexcept {
+	std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+	for (auto it = str.begin(); it != str.end(); it++) {
+		h = (h ^ static_cast<unsigned char>(lower(*it))) * static_cast<std::size_t>(1099511628211ULL);
+	}
+	return h;
+}
+
+/*
+	CaseInsensitiveEqual(lhs, rhs)
+	Returns true if lhs and rhs are the same when converted to lowercase.
+*/
+bool BethYw::StringFilter::CaseInsensitiveEqual::operator()(const std::string& lhs,
+	const std::string& rhs) const noexcept {
+	if (lhs.size() != rhs.size()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < lhs.size(); i++) {
+		if (lower(lhs[i]) != lower(rhs[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+constexpr unsigned int BethYw::YearFilter::OPEN;
+
+/*
+    BethYw::YearFilter::YearFilter()
+
+    Construct a filter that matches every year.
+*/
+BethYw::YearFilter::YearFilter() : YearFilter(std::vector<YearRange>()) {
+}
+
+/*
+    BethYw::YearFilter::YearFilter(first, last)
+
+    Construct a filter for the years first to last, inclusive. If either is
+    0, every year is matched, as the years filter has always done.
+
+    @param first
+        The first year to match
+
+    @param last
+        The last year to match
+*/
+BethYw::YearFilter::YearFilter(const unsigned int first, const unsigned int last)
+	: YearFilter(first == 0 || last == 0
+		? std::vector<YearRange>()
+		: std::vector<YearRange>{YearRange(first, last)}) {
+}
+
+/*
+    BethYw::YearFilter::YearFilter(years)
+
+    Compile a years filter, as returned by BethYw::parseYearsArg().
+
+    @param years
+        A tuple of the first and last year to match, or <0,0> for all years
+*/
+BethYw::YearFilter::YearFilter(const std::tuple<unsigned int, unsigned int>& years)
+	: YearFilter(std::get<0>(years), std::get<1>(years)) {
+}
+
+/*
+    BethYw::YearFilter::YearFilter(years)
+
+    Compile a years filter as above, or construct a filter that matches every
+    year if years is null.
+*/
+BethYw::YearFilter::YearFilter(const std::tuple<unsigned int, unsigned int>* years)
+	: YearFilter(years != nullptr ? YearFilter(*years) : YearFilter()) {
+}
+
+/*
+    BethYw::YearFilter::YearFilter(ranges)
+
+    Compile a set of ranges of years in to a filter. The bitmap covers every
+    year given as the start or end of a range, and the years below and above
+    it are matched if a range is open below or above.
+
+    @param ranges
+        The ranges of years to match, or no ranges to match every year
+
+    @example
+        BethYw::YearFilter census({
+            BethYw::YearRange(1991, 1991),
+            BethYw::YearRange(2001, 2001),
+            BethYw::YearRange(2011, BethYw::YearFilter::OPEN)});
+        census.contains(2015); // true
+*/
+BethYw::YearFilter::YearFilter(const std::vector<YearRange>& ranges)
+	: ranges(ranges), bits(), base(0), size(0), matchBelow(false), matchAbove(false), all(ranges.empty()) {
+	unsigned int lowest = OPEN;
+	unsigned int highest = 0;
+	for (auto it = ranges.begin(); it != ranges.end(); it++) {
+		if (it->first == 0 && it->second == OPEN) {
+			all = true;
+		}
+		if (it->first != 0) {
+			lowest = std::min(lowest, it->first);
+			highest = std::max(highest, it->first);
+		}
+		if (it->second != OPEN) {
+			lowest = std::min(lowest, it->second);
+			highest = std::max(highest, it->second);
+		}
+	}
+	if (all) {
+		matchAbove = true;
+		return;
+	}
+
+	base = lowest;
+	size = highest - lowest + 1;
+	bits.assign((size + 63) / 64, 0);
+	for (auto it = ranges.begin(); it != ranges.end(); it++) {
+		matchBelow = matchBelow || it->first == 0;
+		matchAbove = matchAbove || it->second == OPEN;
+		const unsigned int first = std::max(it->first, lowest);
+		const unsigned int last = std::min(it->second, highest);
+		for (unsigned int year = first; year <= last; year++) {
+			const unsigned int offset = year - base;
+			bits[offset >> 6] |= std::uint64_t(1) << (offset & 63);
+		}
+	}
+}
+
+/*
+	matchesAll()
+	Returns true if the filter matches every year.
+*/
+const bool BethYw::YearFilter::matchesAll() const noexcept {
+	return all;
+}
+
+/*
+	getFirst()
+	Returns the lowest year given, or 0 if every year is matched or the filter
+	is open below.
+*/
+const unsigned int BethYw::YearFilter::getFirst() const noexcept {
+	return (all || matchBelow) ? 0 : base;
+}
+
+/*
+	getLast()
+	Returns the highest year given, or 0 if every year is matched or the
+	filter is open above.
+*/
+const unsigned int BethYw::YearFilter::getLast() const noexcept {
+	return (all || matchAbove) ? 0 : base + size - 1;
+}
+
+/*
+    BethYw::YearFilter::str()
+
+    Describe the filter in the form of the years program argument, e.g. to
+    tell runs with different filters apart. A filter of a single range is
+    described as it always has been (e.g. "2010-2015" or "0-0").
+
+    @return
+        The ranges of the filter separated by commas, with open ends left
+        blank, or "0-0" if every year is matched
+*/
+std::string BethYw::YearFilter::str() const {
+	if (all) {
+		return "0-0";
+	}
+	std::string description;
+	for (auto it = ranges.begin(); it != ranges.end(); it++) {
+		if (it != ranges.begin()) {
+			description += ",";
+		}
+		if (it->first != 0) {
+			description += std::to_string(it->first);
+		}
+		description += "-";
+		if (it->second != OPEN) {
+			description += std::to_string(it->second);
+		}
+	}
+	return description;
+}
@@ -0,0 +1,144 @@
+#ifndef FILTERS_H_
+#define FILTERS_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declarations of StringFilter and YearFilter, the
+    compiled forms of the areas, measures and years filters given on the
+    command line.
+
+    A filter is compiled once, before any file is read, and is not changed
+    afterwards, so one filter can be shared by every thread importing data.
+    Matching is case-insensitive, as the filters were before, but the keys are
+    converted to lowercase when the filter is compiled rather than for every
+    row.
+
+    For the areas filter, which matches any part of an area's code or names,
+    the keys are compiled in to an Aho-Corasick automaton, so a value is
+    searched for every key at once in a single pass over its characters.
+ */
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace BethYw {
+
+/*
+    A set of strings to match values against, e.g. measure codenames. An empty
+    filter, or one compiled from a null set, matches everything.
+
+    The constructors are implicit so that a StringFilterSet (see areas.h), or
+    a pointer to one, can still be passed where a StringFilter is expected.
+*/
+class StringFilter {
+public:
+	StringFilter();
+	StringFilter(const std::unordered_set<std::string>& values);
+	StringFilter(const std::unordered_set<std::string>* values);
+	~StringFilter() = default;
+
+	const bool matchesAll() const noexcept;
+	const bool contains(const std::string& value) const;
+	const bool containsPartOf(const std::string& value) const noexcept;
+	const std::size_t size() const noexcept;
+
+private:
+	/*
+	    Hash and compare strings as if they were lowercase, so a value can be
+	    looked up without converting it first.
+	*/
+	struct CaseInsensitiveHash {
+		std::size_t operator()(const std::string& str) const noexcept;
+	};
+
+	struct CaseInsensitiveEqual {
+		bool operator()(const std::string& lhs, const std::string& rhs) const noexcept;
+	};
+
+	std::unordered_set<std::string, CaseInsensitiveHash, CaseInsensitiveEqual> keys;
+
+	/*
+	    The automaton used by containsPartOf(). Each byte is mapped to a
+	    class, with upper and lowercase letters sharing a class and every byte
+	    that is in no key sharing class 0. The next state after reading a byte
+	    is transitions[state * classCount + class], and a state is accepting if
+	    a key ends there, including keys that are a suffix of another.
+	*/
+	std::uint16_t byteClass[256];
+	std::size_t classCount;
+	std::vector<std::uint32_t> transitions;
+	std::vector<char> accepting;
+
+	void compile();
+};
+
+/*
+    An inclusive range of years. A first year of 0 leaves the range open
+    below, and a last year of YearFilter::OPEN leaves it open above.
+*/
+using YearRange = std::pair<unsigned int, unsigned int>;
+
+/*
+    A set of years, made up of any number of ranges, e.g. the census years
+    1991, 2001 and 2011 and every year from 2015. A filter of <0,0>, one
+    compiled from a null tuple or one with no ranges matches every year.
+
+    The years are held in a bitmap from the lowest to the highest year given,
+    with a flag each for the years below and above it, so looking a year up
+    is a few instructions however many ranges there are.
+*/
+class YearFilter {
+public:
+	static constexpr unsigned int OPEN = UINT_MAX;
+
+	YearFilter();
+	YearFilter(const unsigned int first, const unsigned int last);
+	YearFilter(const std::tuple<unsigned int, unsigned int>& years);
+	YearFilter(const std::tuple<unsigned int, unsigned int>* years);
+	explicit YearFilter(const std::vector<YearRange>& ranges);
+	~YearFilter() = default;
+
+	const bool matchesAll() const noexcept;
+	const unsigned int getFirst() const noexcept;
+	const unsigned int getLast() const noexcept;
+	std::string str() const;
+
+	/*
+	    Returns true if the year is in the filter. This is called for every
+	    reading, so is defined here to be inlined.
+	*/
+	const bool contains(const unsigned int year) const noexcept {
+		if (year < base) {
+			return matchBelow;
+		}
+		const unsigned int offset = year - base;
+		if (offset >= size) {
+			return matchAbove;
+		}
+		return ((bits[offset >> 6] >> (offset & 63)) & 1) != 0;
+	}
+
+private:
+	std::vector<YearRange> ranges;
+	std::vector<std::uint64_t> bits;
+	unsigned int base;
+	unsigned int size;
+	bool matchBelow;
+	bool matchAbove;
+	bool all;
+};
+
+} // namespace BethYw
+
+#endif // FILTERS_H_
@@ -0,0 +1,203 @@
+#ifndef FLATMAP_H_
+#define FLATMAP_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains FlatMap, an open addressing hash map that can stand in
+    for the std::map in AreasContainer (see areas.h) when Beth Yw? is built
+    with -DBETHYW_FLAT_AREAS.
+
+    Entries are stored in insertion order in a std::deque, which allocates
+    them in chunks and never moves them, so references to entries stay valid
+    as the map grows, as they do with std::map. They are found through a
+    flat array of positions in the deque, probed linearly from the hash of
+    the key, so a lookup is usually a single array access and one key
+    comparison.
+
+    Only the parts of the std::map interface that Areas uses are provided,
+    and iteration is in insertion order, not key order: Areas sorts the keys
+    when it outputs them instead. Entries cannot be erased, only cleared.
+ */
+
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace BethYw {
+
+template <typename Key,
+	typename T,
+	typename Hash = std::hash<Key>,
+	typename KeyEqual = std::equal_to<Key>,
+	typename Allocator = std::allocator<std::pair<const Key, T>>>
+class FlatMap {
+public:
+	using key_type = Key;
+	using mapped_type = T;
+	using value_type = std::pair<const Key, T>;
+	using size_type = std::size_t;
+	using hasher = Hash;
+	using key_equal = KeyEqual;
+	using allocator_type = Allocator;
+
+private:
+	using Entries = std::deque<value_type, Allocator>;
+	using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<std::uint32_t>;
+
+public:
+	using iterator = typename Entries::iterator;
+	using const_iterator = typename Entries::const_iterator;
+
+	FlatMap() : FlatMap(Allocator()) {}
+
+	explicit FlatMap(const Allocator& allocator)
+		: entries(allocator), slots(SlotAllocator(allocator)), mask(0), hash(), equal() {}
+
+	FlatMap(const FlatMap& other) = default;
+	FlatMap(FlatMap&& other) = default;
+	FlatMap& operator=(FlatMap&& other) = default;
+
+	/*
+	    The entries cannot be assigned to as their keys are const, so the
+	    copy is built and then swapped in.
+	*/
+	FlatMap& operator=(const FlatMap& other) {
+		if (this != &other) {
+			FlatMap copy(other);
+			swap(copy);
+		}
+		return *this;
+	}
+
+	iterator begin() noexcept { return entries.begin(); }
+	iterator end() noexcept { return entries.end(); }
+	const_iterator begin() const noexcept { return entries.begin(); }
+	const_iterator end() const noexcept { return entries.end(); }
+
+	size_type size() const noexcept { return entries.size(); }
+	size_type bucket_count() const noexcept { return slots.size(); }
+	bool empty() const noexcept { return entries.empty(); }
+	allocator_type get_allocator() const { return entries.get_allocator(); }
+
+	iterator find(const Key& key) {
+		std::uint32_t position = lookup(key);
+		return position ? entries.begin() + (position - 1) : entries.end();
+	}
+
+	const_iterator find(const Key& key) const {
+		std::uint32_t position = lookup(key);
+		return position ? entries.begin() + (position - 1) : entries.end();
+	}
+
+	size_type count(const Key& key) const {
+		return lookup(key) ? 1 : 0;
+	}
+
+	/*
+	    Add an entry if its key is not already in the map. Returns the
+	    entry with the key and whether it was added.
+	*/
+	std::pair<iterator, bool> insert(value_type&& value) {
+		std::uint32_t position = lookup(value.first);
+		if (position) {
+			return std::make_pair(entries.begin() + (position - 1), false);
+		}
+		if (entries.size() >= static_cast<std::size_t>(UINT32_MAX - 1)) {
+			throw std::length_error("FlatMap::insert: Too many entries");
+		}
+		if ((entries.size() + 1) * 2 > slots.size()) {
+			grow();
+		}
+		entries.push_back(std::move(value));
+		place(entries.back().first, static_cast<std::uint32_t>(entries.size()));
+		return std::make_pair(entries.end() - 1, true);
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return insert(value_type(value));
+	}
+
+	/*
+	    As insert(value), the hint is ignored.
+	*/
+	iterator insert(const_iterator, value_type&& value) {
+		return insert(std::move(value)).first;
+	}
+
+	void clear() noexcept {
+		entries.clear();
+		std::fill(slots.begin(), slots.end(), 0);
+	}
+
+	void swap(FlatMap& other) {
+		entries.swap(other.entries);
+		slots.swap(other.slots);
+		std::swap(mask, other.mask);
+	}
+
+private:
+	Entries entries;
+
+	/*
+	    A power of two number of slots, each 0 if empty or the position of an
+	    entry plus one. There are always at least twice as many slots as
+	    entries, so runs of full slots stay short.
+	*/
+	std::vector<std::uint32_t, SlotAllocator> slots;
+	std::size_t mask;
+	Hash hash;
+	KeyEqual equal;
+
+	/*
+	    Spread the bits of the hash, as hashes of small integers (e.g. the
+	    encoded area codes) only differ in their low bits.
+	*/
+	std::size_t start(const Key& key) const {
+		std::uint64_t h = static_cast<std::uint64_t>(hash(key)) * UINT64_C(0x9E3779B97F4A7C15);
+		return static_cast<std::size_t>(h >> 32) & mask;
+	}
+
+	std::uint32_t lookup(const Key& key) const {
+		if (slots.empty()) {
+			return 0;
+		}
+		for (std::size_t i = start(key);; i = (i + 1) & mask) {
+			std::uint32_t position = slots[i];
+			if (position == 0 || equal(entries[position - 1].first, key)) {
+				return position;
+			}
+		}
+	}
+
+	void place(const Key& key, const std::uint32_t position) {
+		std::size_t i = start(key);
+		while (slots[i] != 0) {
+			i = (i + 1) & mask;
+		}
+		slots[i] = position;
+	}
+
+	void grow() {
+		std::size_t size = slots.empty() ? 16 : slots.size() * 2;
+		slots.assign(size, 0);
+		mask = size - 1;
+		for (std::size_t i = 0; i < entries.size(); i++) {
+			place(entries[i].first, static_cast<std::uint32_t>(i + 1));
+		}
+	}
+};
+
+} // namespace BethYw
+
+#endif // FLATMAP_H_
@@ -17,8 +17,211 @@
     functions not specified.
  */
 
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#ifdef BETHYW_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "input.h"
 
+namespace {
+
+/*
+    The number of bytes of compressed data read at a time, and the number of
+    bytes of decompressed data made available to the stream at a time.
+*/
+constexpr std::size_t COMPRESSED_BLOCK_SIZE = 64 * 1024;
+constexpr std::size_t DECOMPRESSED_BLOCK_SIZE = 256 * 1024;
+
+/*
+    A read-only stream buffer that decompresses another stream a block at a
+    time. Derived classes implement decompress() for each format.
+
+    Corrupt or truncated data is reported by throwing a std::runtime_error
+    from underflow(), which reaches the parser through the stream.
+*/
+class DecompressBuffer : public std::streambuf {
+public:
+	DecompressBuffer(std::istream& compressed, const std::string& source)
+		: std::streambuf(), compressed(compressed), source(source),
+		in(COMPRESSED_BLOCK_SIZE), inSize(0), out(DECOMPRESSED_BLOCK_SIZE) {
+	}
+
+	virtual ~DecompressBuffer() = default;
+
+protected:
+	std::istream& compressed;
+	std::string source;
+	std::vector<char> in;
+	std::size_t inSize;
+	std::vector<char> out;
+
+	/*
+		Decompress in to out, reading more compressed data as needed, and return
+		the number of bytes written to out. Returns 0 at the end of the data.
+	*/
+	virtual std::size_t decompress() = 0;
+
+	/*
+		Read the next block of compressed data in to in. Returns false if there
+		is nothing left to read.
+	*/
+	bool readInput() {
+		compressed.read(in.data(), in.size());
+		inSize = static_cast<std::size_t>(compressed.gcount());
+		return inSize > 0;
+	}
+
+	[[noreturn]] void corrupt() const {
+		throw std::runtime_error("InputCompressedFile: Corrupt or truncated data in " + source);
+	}
+
+	int_type underflow() {
+		if (gptr() < egptr()) {
+			return traits_type::to_int_type(*gptr());
+		}
+		std::size_t count = decompress();
+		if (count == 0) {
+			return traits_type::eof();
+		}
+		setg(out.data(), out.data(), out.data() + count);
+		return traits_type::to_int_type(*gptr());
+	}
+};
+
+/*
+    Decompresses gzip (or zlib) data with zlib. Files with several gzip
+    members one after another, as made by concatenating .gz files, are read
+    as one.
+*/
+class GzipBuffer : public DecompressBuffer {
+public:
+	GzipBuffer(std::istream& compressed, const std::string& source)
+		: DecompressBuffer(compressed, source), stream(), finished(false), pending(false) {
+		// 15 is the largest window size, adding 32 detects gzip or zlib headers
+		if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+			throw std::runtime_error("InputCompressedFile: Failed to start decompressing " + source);
+		}
+	}
+
+	~GzipBuffer() {
+		inflateEnd(&stream);
+	}
+
+protected:
+	std::size_t decompress() {
+		stream.next_out = reinterpret_cast<Bytef*>(out.data());
+		stream.avail_out = static_cast<uInt>(out.size());
+		while (stream.avail_out == out.size()) {
+			if (finished) {
+				// A member has ended with all of its output written, so either
+				// this is the end of the data or another member follows
+				if (stream.avail_in == 0) {
+					if (!readInput()) {
+						break;
+					}
+					stream.next_in = reinterpret_cast<Bytef*>(in.data());
+					stream.avail_in = static_cast<uInt>(inSize);
+				}
+				inflateReset(&stream);
+				finished = false;
+			} else if (stream.avail_in == 0 && !pending) {
+				if (!readInput()) {
+					corrupt();
+				}
+				stream.next_in = reinterpret_cast<Bytef*>(in.data());
+				stream.avail_in = static_cast<uInt>(inSize);
+			}
+
+			int result = inflate(&stream, Z_NO_FLUSH);
+			if (result == Z_STREAM_END) {
+				finished = true;
+			} else if (result != Z_OK && result != Z_BUF_ERROR) {
+				corrupt();
+			}
+			pending = stream.avail_out == 0;
+		}
+		return out.size() - stream.avail_out;
+	}
+
+private:
+	z_stream stream;
+	bool finished;
+	bool pending;
+};
+
+#ifdef BETHYW_HAVE_ZSTD
+
+/*
+    Decompresses zstd data with libzstd. Several frames one after another are
+    read as one.
+*/
+class ZstdBuffer : public DecompressBuffer {
+public:
+	ZstdBuffer(std::istream& compressed, const std::string& source)
+		: DecompressBuffer(compressed, source), stream(ZSTD_createDStream()), input(),
+		finished(false), pending(false) {
+		if (stream == nullptr || ZSTD_isError(ZSTD_initDStream(stream))) {
+			ZSTD_freeDStream(stream);
+			throw std::runtime_error("InputCompressedFile: Failed to start decompressing " + source);
+		}
+	}
+
+	~ZstdBuffer() {
+		ZSTD_freeDStream(stream);
+	}
+
+protected:
+	std::size_t decompress() {
+		ZSTD_outBuffer output = {out.data(), out.size(), 0};
+		while (output.pos == 0) {
+			// A finished frame has no output left to flush, so only read more
+			// input after it, which keeps finished set at the end of the data
+			if (input.pos == input.size && (finished || !pending)) {
+				if (!readInput()) {
+					if (!finished) {
+						corrupt();
+					}
+					break;
+				}
+				input.src = in.data();
+				input.size = inSize;
+				input.pos = 0;
+			}
+
+			std::size_t result = ZSTD_decompressStream(stream, &output, &input);
+			if (ZSTD_isError(result)) {
+				corrupt();
+			}
+			finished = result == 0;
+			pending = output.pos == output.size;
+		}
+		return output.pos;
+	}
+
+private:
+	ZSTD_DStream* stream;
+	ZSTD_inBuffer input;
+	bool finished;
+	bool pending;
+};
+
+#endif // BETHYW_HAVE_ZSTD
+
+} // namespace
+
 /*
     TODO: InputSource::InputSource(source)
 
@@ -88,3 +291,332 @@ InputFile::~InputFile() {
 		inStream.close();
 	}
 }
+
+/*
+    InputMemoryBuffer::InputMemoryBuffer()
+
+    Construct a stream buffer with nothing in it.
+*/
+InputMemoryBuffer::InputMemoryBuffer() : std::streambuf() {
+}
+
+/*
+    InputMemoryBuffer::setView(data, size)
+
+    Point the buffer at a block of memory. The memory is not copied, and must
+    outlive any stream using this buffer.
+
+    @param data
+        Start of the block of memory
+
+    @param size
+        Number of bytes in the block
+*/
+void InputMemoryBuffer::setView(const char* data, std::size_t size) {
+	char* begin = const_cast<char*>(data);
+	setg(begin, begin, begin + size);
+}
+
+/*
+    InputMemoryBuffer::data()
+
+    @return
+        The next unread byte of the buffer
+*/
+const char* InputMemoryBuffer::data() const noexcept {
+	return gptr();
+}
+
+/*
+    InputMemoryBuffer::size()
+
+    @return
+        The number of unread bytes left in the buffer
+*/
+std::size_t InputMemoryBuffer::size() const noexcept {
+	return static_cast<std::size_t>(egptr() - gptr());
+}
+
+/*
+    InputMemoryBuffer::seekoff(off, dir, which)
+
+    Move the read position relative to the start, end, or the current position,
+    so that seekg() and tellg() work on the stream.
+*/
+InputMemoryBuffer::pos_type InputMemoryBuffer::seekoff(off_type off,
+	std::ios_base::seekdir dir,
+	std::ios_base::openmode which) {
+	if (!(which & std::ios_base::in)) {
+		return pos_type(off_type(-1));
+	}
+
+	off_type base = 0;
+	if (dir == std::ios_base::cur) {
+		base = gptr() - eback();
+	} else if (dir == std::ios_base::end) {
+		base = egptr() - eback();
+	}
+
+	off_type target = base + off;
+	if (target < 0 || target > egptr() - eback()) {
+		return pos_type(off_type(-1));
+	}
+	setg(eback(), eback() + target, egptr());
+	return pos_type(target);
+}
+
+/*
+    InputMemoryBuffer::seekpos(pos, which)
+
+    Move the read position to an absolute position.
+*/
+InputMemoryBuffer::pos_type InputMemoryBuffer::seekpos(pos_type pos,
+	std::ios_base::openmode which) {
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+/*
+    InputMappedFile:InputMappedFile(path)
+
+    Constructor for a memory mapped file source. The file is not opened until
+    open() is called.
+
+    @param path
+        The complete path for a file to import.
+
+    @example
+        InputMappedFile input("data/popu1009.json");
+*/
+InputMappedFile::InputMappedFile(const std::string& filePath)
+	: InputSource(filePath), mapping(nullptr), length(0), mapped(false),
+	contents(), buffer(), inStream(&buffer) {
+}
+
+/*
+    InputMappedFile::open()
+
+    Map the file at getSource() read-only in to memory, advise the kernel that
+    we will read it from start to end, and return a reference to a stream that
+    reads directly out of the mapping. Calling open() again rewinds the stream.
+
+    @return
+        A standard input stream reference
+
+    @throws
+        std::runtime_error if there is an issue opening the file, with the message:
+        InputMappedFile::open: Failed to open file <file name>
+
+    @example
+        InputMappedFile input("data/popu1009.json");
+        std::istream &is = input.open();
+*/
+std::istream& InputMappedFile::open() {
+	if (mapping == nullptr) {
+#ifdef _WIN32
+		std::ifstream file(source, std::ifstream::in | std::ifstream::binary);
+		if (!file.is_open()) {
+			throw std::runtime_error("InputMappedFile::open: Failed to open file " + source);
+		}
+		contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		mapping = contents.data();
+		length = contents.size();
+#else
+		int fd = ::open(source.c_str(), O_RDONLY);
+		struct stat info;
+		if (fd < 0 || ::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+			if (fd >= 0) {
+				::close(fd);
+			}
+			throw std::runtime_error("InputMappedFile::open: Failed to open file " + source);
+		}
+
+		length = static_cast<std::size_t>(info.st_size);
+		if (length > 0) {
+			void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (addr == MAP_FAILED) {
+				::close(fd);
+				throw std::runtime_error("InputMappedFile::open: Failed to open file " + source);
+			}
+			::madvise(addr, length, MADV_SEQUENTIAL);
+			::madvise(addr, length, MADV_WILLNEED);
+			mapping = static_cast<const char*>(addr);
+			mapped = true;
+		}
+		::close(fd);
+#endif
+	}
+
+	buffer.setView(mapping, length);
+	inStream.clear();
+	return inStream;
+}
+
+/*
+    InputMappedFile::data()
+
+    @return
+        The start of the file contents in memory, or nullptr if the file has
+        not been opened or is empty
+*/
+const char* InputMappedFile::data() const noexcept {
+	return mapping;
+}
+
+/*
+    InputMappedFile::size()
+
+    @return
+        The number of bytes in the file, or 0 if the file has not been opened
+*/
+std::size_t InputMappedFile::size() const noexcept {
+	return length;
+}
+
+/*
+	close()
+	Unmap the file (if it is mapped).
+*/
+void InputMappedFile::close() noexcept {
+#ifndef _WIN32
+	if (mapped) {
+		::munmap(const_cast<char*>(mapping), length);
+	}
+#endif
+	mapping = nullptr;
+	length = 0;
+	mapped = false;
+}
+
+InputMappedFile::~InputMappedFile() {
+	close();
+}
+
+/*
+    detectCompression(filePath)
+
+    Work out whether a file is compressed, first from its extension (.gz or
+    .zst) and otherwise from the magic bytes at the start of the file.
+
+    @param filePath
+        The path of the file
+
+    @return
+        The compression format of the file, or NoCompression if it is not
+        compressed or cannot be opened
+
+    @example
+        if (detectCompression("datasets/popu1009.json.gz") == GzipCompression) {
+            ...
+        }
+*/
+InputCompression detectCompression(const std::string& filePath) {
+	auto endsWith = [&filePath](const std::string& extension) {
+		return filePath.size() >= extension.size() &&
+			filePath.compare(filePath.size() - extension.size(), extension.size(), extension) == 0;
+	};
+	if (endsWith(".gz")) {
+		return GzipCompression;
+	} else if (endsWith(".zst")) {
+		return ZstdCompression;
+	}
+
+	unsigned char magic[4] = {0, 0, 0, 0};
+	std::ifstream file(filePath, std::ifstream::in | std::ifstream::binary);
+	file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+	if (file.gcount() >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+		return GzipCompression;
+	} else if (file.gcount() == 4 &&
+		magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+		return ZstdCompression;
+	}
+	return NoCompression;
+}
+
+/*
+    InputCompressedFile::InputCompressedFile(filePath, compression)
+
+    Construct an input source for a compressed file. The file is not opened
+    until open() is called.
+
+    @param filePath
+        A path to a compressed file
+
+    @param compression
+        The compression format of the file (see detectCompression())
+
+    @example
+        InputCompressedFile input("data/popu1009.json.gz", GzipCompression);
+*/
+InputCompressedFile::InputCompressedFile(const std::string& filePath,
+	const InputCompression compression)
+	: InputSource(filePath), compression(compression), file(), buffer(), inStream(nullptr) {
+}
+
+/*
+    InputCompressedFile::open()
+
+    Open the compressed file and return a reference to a stream of its
+    decompressed contents. Calling open() again starts from the beginning.
+
+    @return
+        A standard input stream reference. Reading corrupt data from the stream
+        throws a std::runtime_error.
+
+    @throws
+        std::runtime_error if there is an issue opening the file, with the message:
+        InputCompressedFile::open: Failed to open file <file name>
+
+        std::runtime_error if the file is zstd compressed and zstd support was
+        not built in
+
+    @example
+        InputCompressedFile input("data/popu1009.json.gz", GzipCompression);
+        std::istream &is = input.open();
+*/
+std::istream& InputCompressedFile::open() {
+	inStream.exceptions(std::istream::goodbit);
+	inStream.rdbuf(nullptr);
+	buffer.reset();
+	if (file.is_open()) {
+		file.close();
+	}
+	file.clear();
+
+	file.open(source, std::ifstream::in | std::ifstream::binary);
+	if (!file.is_open()) {
+		throw std::runtime_error("InputCompressedFile::open: Failed to open file " + source);
+	}
+
+	if (compression == GzipCompression) {
+		buffer.reset(new GzipBuffer(file, source));
+	} else if (compression == ZstdCompression) {
+#ifdef BETHYW_HAVE_ZSTD
+		buffer.reset(new ZstdBuffer(file, source));
+#else
+		throw std::runtime_error("InputCompressedFile::open: zstd support was not built in for " + source);
+#endif
+	} else {
+		throw std::runtime_error("InputCompressedFile::open: File is not compressed " + source);
+	}
+
+	inStream.rdbuf(buffer.get());
+	inStream.clear();
+	inStream.exceptions(std::istream::badbit);
+	return inStream;
+}
+
+/*
+    InputCompressedFile::getCompression()
+
+    @return
+        The compression format of the file
+*/
+const InputCompression InputCompressedFile::getCompression() const noexcept {
+	return compression;
+}
+
+InputCompressedFile::~InputCompressedFile() {
+	if (file.is_open()) {
+		file.close();
+	}
+}
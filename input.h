@@ -8,21 +8,27 @@
 
     AUTHOR: 979248
 
-    This file contains declarations for the input source handlers. There are
-    two classes: InputSource and InputFile. InputSource is abstract (i.e. it
-    contains a pure virtual function). InputFile is a concrete derivation of
-    InputSource, for input from files.
+    This file contains declarations for the input source handlers. InputSource
+    is abstract (i.e. it contains a pure virtual function). InputFile is a
+    concrete derivation of InputSource, for input from files, and
+    InputMappedFile is another, for input from files that are mapped in to
+    memory rather than read through a file stream. InputCompressedFile reads
+    gzip or zstd compressed files, decompressing them as they are read.
 
-    Although only one class derives from InputSource, we have implemented our
-    code this way to support future expansion of input from different sources
-    (e.g. the web).
+    We have implemented our code this way to support future expansion of input
+    from different sources (e.g. the web).
 
     TODO: Read the block comments with TODO in input.cpp to know which 
     functions and member variables you need to declare in these classes.
  */
 
+#include <cstddef>
 #include <string>
 #include <fstream>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <vector>
 
 /*
     InputSource is an abstract/purely virtual base class for all input source 
@@ -38,10 +44,11 @@ class InputSource {
 protected:
     std::string source;
     InputSource(const std::string& source);
-	virtual ~InputSource() = default;
 
 public:
+	virtual ~InputSource() = default;
 	virtual const std::string getSource() const;
+	virtual std::istream& open() = 0;
 };
 
 /*
@@ -60,4 +67,88 @@ public:
 	std::ifstream inStream;
 };
 
+/*
+    A read-only stream buffer over a contiguous block of memory that is owned
+    by someone else. Reading from a std::istream using this buffer reads
+    straight out of the memory, without copying it in to a buffer first.
+*/
+class InputMemoryBuffer : public std::streambuf {
+public:
+	InputMemoryBuffer();
+	void setView(const char* data, std::size_t size);
+	const char* data() const noexcept;
+	std::size_t size() const noexcept;
+
+protected:
+	pos_type seekoff(off_type off,
+		std::ios_base::seekdir dir,
+		std::ios_base::openmode which = std::ios_base::in);
+	pos_type seekpos(pos_type pos,
+		std::ios_base::openmode which = std::ios_base::in);
+};
+
+/*
+    Source data that is contained within a file, which is mapped read-only in
+    to memory. The contents of the file can be read through the stream returned
+    by open(), or directly as a contiguous block of bytes with data() and
+    size().
+
+    On platforms without mmap(), the file is read in to memory instead.
+*/
+class InputMappedFile : public InputSource {
+public:
+	InputMappedFile(const std::string& filePath);
+	~InputMappedFile();
+	InputMappedFile(const InputMappedFile&) = delete;
+	InputMappedFile& operator=(const InputMappedFile&) = delete;
+	std::istream& open();
+	const char* data() const noexcept;
+	std::size_t size() const noexcept;
+
+private:
+	const char* mapping;
+	std::size_t length;
+	bool mapped;
+	std::vector<char> contents;
+	InputMemoryBuffer buffer;
+	std::istream inStream;
+	void close() noexcept;
+};
+
+/*
+    The compression formats understood by InputCompressedFile.
+*/
+enum InputCompression {
+  NoCompression,
+  GzipCompression,
+  ZstdCompression
+};
+
+InputCompression detectCompression(const std::string& filePath);
+
+/*
+    Source data that is contained within a gzip (.gz) or zstd (.zst)
+    compressed file. The stream returned by open() decompresses the file in
+    small blocks as it is read, so the uncompressed data is never written to
+    disk or held in memory all at once.
+
+    gzip support uses zlib. zstd support needs libzstd, and is only built if
+    BETHYW_HAVE_ZSTD is defined.
+*/
+class InputCompressedFile : public InputSource {
+public:
+	InputCompressedFile(const std::string& filePath, const InputCompression compression);
+	~InputCompressedFile();
+	InputCompressedFile(const InputCompressedFile&) = delete;
+	InputCompressedFile& operator=(const InputCompressedFile&) = delete;
+	std::istream& open();
+	const InputCompression getCompression() const noexcept;
+
+private:
+	InputCompression compression;
+	std::ifstream file;
+	std::unique_ptr<std::streambuf> buffer;
+	std::istream inStream;
+};
+
 #endif // INPUT_H_
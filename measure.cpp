@@ -18,6 +18,7 @@
   must implement has a TODO block comment. 
 */
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <cstdlib>
@@ -25,6 +26,18 @@
 #include "measure.h"
 #include "bethyw.h"
 
+namespace {
+
+/*
+    Dense storage is used while the span of years is at most this long, or
+    at most DENSE_SPAN_FACTOR times the number of readings, whichever is
+    larger. Beyond that the gaps waste more memory than a std::map would use.
+*/
+constexpr unsigned long long MIN_DENSE_SPAN = 64;
+constexpr unsigned long long DENSE_SPAN_FACTOR = 4;
+
+} // namespace
+
 /*
   TODO: Measure::Measure(codename, label);
 
@@ -44,16 +57,36 @@
     std::string label = "Population";
     Measure measure(codename, label);
 */
-Measure::Measure(const std::string codename, const std::string &label) : label(label) {
-	std::string codenameToLowercase = "";
-	for (std::string::size_type i = 0; i < codename.length(); i++) {
-		if (codename[i] <= 'Z' && codename[i] >= 'A') {
-			codenameToLowercase += (codename[i] + 32);
-		} else {
-			codenameToLowercase += codename[i];
-		}
-	}
-	this->codename = codenameToLowercase;
+Measure::Measure(const std::string codename, const std::string &label)
+	: Measure(codename, label, nullptr) {
+}
+
+/*
+  Measure::Measure(codename, label, arena)
+
+  Construct a Measure whose readings are allocated from an Arena, see
+  arena.h. Areas passes its Arena to each Measure created by upsertMeasure().
+
+  @param codename
+    The codename for the measure
+
+  @param label
+    Human-readable (i.e. nice/explanatory) label for the measure
+
+  @param arena
+    The Arena to allocate from, or nullptr to use the heap
+*/
+Measure::Measure(const std::string& codename,
+	const std::string &label,
+	std::shared_ptr<BethYw::Arena> arena)
+	: codename(BethYw::internLowercase(codename)),
+	label(BethYw::intern(label)),
+	baseYear(0),
+	dense(BethYw::ArenaAllocator<double>(arena)),
+	present(BethYw::ArenaAllocator<bool>(arena)),
+	sparse(BethYw::ArenaAllocator<std::pair<const unsigned int, double>>(arena)),
+	isSparse(false),
+	count(0) {
 }
 
 /*
@@ -75,8 +108,8 @@ Measure::Measure(const std::string codename, const std::string &label) : label(l
     ...
     auto codename2 = measure.getCodename();
 */
-const std::string Measure::getCodename() const noexcept {
-	return codename;
+const std::string& Measure::getCodename() const noexcept {
+	return codename.str();
 }
 
 /*
@@ -98,8 +131,8 @@ const std::string Measure::getCodename() const noexcept {
     ...
     auto label = measure.getLabel();
 */
-const std::string Measure::getLabel() const noexcept {
-	return label;
+const std::string& Measure::getLabel() const noexcept {
+	return label.str();
 }
 
 /*
@@ -117,7 +150,7 @@ const std::string Measure::getLabel() const noexcept {
     measure.setLabel("New Population");
 */
 void Measure::setLabel(const std::string label) {
-	this->label = label;
+	this->label = BethYw::intern(label);
 }
 
 /*
@@ -148,14 +181,12 @@ void Measure::setLabel(const std::string label) {
     auto value = measure.getValue(1999); // returns 12345678.9
 */
 const double Measure::getValue(const unsigned int key) const {
-	double value;
-	if (values.count(key)) {
-		value = values.at(key);
-	} else {
-		std::string keyString = std::to_string(key);
-		throw std::out_of_range("No value found for year " + keyString);
+	const double* value = findValue(key);
+	if (value != nullptr) {
+		return *value;
 	}
-	return value;
+	std::string keyString = std::to_string(key);
+	throw std::out_of_range("No value found for year " + keyString);
 }
 /*
   TODO: Measure::setValue(key, value)
@@ -180,7 +211,80 @@ const double Measure::getValue(const unsigned int key) const {
     measure.setValue(1999, 12345678.9);
 */
 void Measure::setValue(const unsigned int year, const double value) {
-	values[year] = value;
+	if (!isSparse && count > 0 &&
+		!fitsDense(std::min(year, baseYear), std::max<unsigned int>(year, baseYear + dense.size() - 1))) {
+		makeSparse();
+	}
+
+	if (isSparse) {
+		auto inserted = sparse.insert(std::make_pair(year, value));
+		if (inserted.second) {
+			count++;
+		} else {
+			inserted.first->second = value;
+		}
+		return;
+	}
+
+	if (dense.empty()) {
+		baseYear = year;
+	} else if (year < baseYear) {
+		std::size_t shift = baseYear - year;
+		dense.insert(dense.begin(), shift, 0.0);
+		present.insert(present.begin(), shift, false);
+		baseYear = year;
+	}
+	std::size_t index = year - baseYear;
+	if (index >= dense.size()) {
+		dense.resize(index + 1, 0.0);
+		present.resize(index + 1, false);
+	}
+	if (!present[index]) {
+		present[index] = true;
+		count++;
+	}
+	dense[index] = value;
+}
+
+/*
+	fitsDense(first, last)
+	Returns true if readings from first to last (inclusive) should be stored
+	densely, given the number of readings there will be.
+*/
+const bool Measure::fitsDense(const unsigned int first, const unsigned int last) const noexcept {
+	unsigned long long span = static_cast<unsigned long long>(last) - first + 1;
+	return span <= std::max(MIN_DENSE_SPAN, DENSE_SPAN_FACTOR * (count + 1));
+}
+
+/*
+	makeSparse()
+	Move the readings from the dense array in to the sparse map.
+*/
+void Measure::makeSparse() {
+	forEachValue([this](const unsigned int year, const double value) {
+		sparse.insert(sparse.end(), std::make_pair(year, value));
+	});
+	dense.clear();
+	dense.shrink_to_fit();
+	present.clear();
+	present.shrink_to_fit();
+	isSparse = true;
+}
+
+/*
+	firstValue()
+	Returns the reading for the earliest year. There must be at least one.
+*/
+const double Measure::firstValue() const noexcept {
+	return isSparse ? sparse.begin()->second : dense.front();
+}
+
+/*
+	lastValue()
+	Returns the reading for the latest year. There must be at least one.
+*/
+const double Measure::lastValue() const noexcept {
+	return isSparse ? sparse.rbegin()->second : dense.back();
 }
 
 /*
@@ -202,7 +306,7 @@ void Measure::setValue(const unsigned int year, const double value) {
     auto size = measure.size(); // returns 1
 */
 const int Measure::size() const noexcept{
-	return values.size();
+	return count;
 }
 
 /*
@@ -225,8 +329,8 @@ const int Measure::size() const noexcept{
 const double Measure::getDifference() const noexcept {
 	double diff = 0;
 	if (size() >= 2) {
-		double earliestYear = values.begin()->second;
-		double oldestYear = values.rbegin()->second;
+		double earliestYear = firstValue();
+		double oldestYear = lastValue();
 		diff = std::abs(earliestYear - oldestYear);
 	}
 	return diff;
@@ -252,7 +356,7 @@ const double Measure::getDifference() const noexcept {
 const double Measure::getDifferenceAsPercentage() const noexcept {
 	double diff = 0;
 	if (size() >= 2) {
-		double earliestYear = values.begin()->second;
+		double earliestYear = firstValue();
 		diff = getDifference() / earliestYear;
 	}
 	return diff * 100;
@@ -276,9 +380,9 @@ const double Measure::getDifferenceAsPercentage() const noexcept {
 */
 const double Measure::getAverage() const noexcept {
 	double average = 0;
-	for (auto it = values.begin(); it != values.end(); it++) {
-		average += it->second;
-	}
+	forEachValue([&average](const unsigned int, const double value) {
+		average += value;
+	});
 	if (size()) {
 		average = average / size();
 	}
@@ -322,20 +426,20 @@ const double Measure::getAverage() const noexcept {
     measure.setValue(1999, 12345678.9);
     std::cout << measure << std::end;
 */
-std::ostream &operator<<(std::ostream &output, const Measure measure) {
+std::ostream &operator<<(std::ostream &output, const Measure& measure) {
 	output << measure.getLabel() << " (" << measure.getCodename() << ")" << std::endl;
 	std::string years = "";
 	std::string values = "";
 	if (!measure.size()) {
 		output << "<no data>" << std::endl;	
 	} else {
-		for (auto it = measure.values.begin(); it != measure.values.end(); it++) {
-			std::string year = std::to_string(it->first);
-			std::string value = std::to_string(it->second);
+		measure.forEachValue([&](const unsigned int yearKey, const double reading) {
+			std::string year = std::to_string(yearKey);
+			std::string value = std::to_string(reading);
 			BethYw::rightAlignTwoStrings(year, value);
 			years += year + " ";
 			values += value + " ";
-		}
+		});
 		//Average column
 		std::string title = "Average";
 		std::string val = std::to_string(measure.getAverage());
@@ -376,10 +480,53 @@ std::ostream &operator<<(std::ostream &output, const Measure measure) {
     true if both Measure objects have the same codename, label and data; false
     otherwise
 */
-bool operator==(const Measure lhs, const Measure rhs) {
-	return (lhs.getLabel() == rhs.getLabel() &&
-		lhs.getCodename() == rhs.getCodename() && 
-		lhs.getValues() == rhs.getValues());
+bool operator==(const Measure& lhs, const Measure& rhs) {
+	if (lhs.label != rhs.label || lhs.codename != rhs.codename || lhs.count != rhs.count) {
+		return false;
+	}
+	bool equal = true;
+	lhs.forEachValue([&rhs, &equal](const unsigned int year, const double value) {
+		const double* other = rhs.findValue(year);
+		equal = equal && other != nullptr && *other == value;
+	});
+	return equal;
+}
+
+/*
+	findValue(year)
+	Returns a pointer to the reading for a year, or nullptr if there is none.
+	Unlike getValue(), this does not throw if there is no reading.
+*/
+const double* Measure::findValue(const unsigned int year) const noexcept {
+	if (isSparse) {
+		auto it = sparse.find(year);
+		if (it != sparse.end()) {
+			return &it->second;
+		}
+	} else if (year >= baseYear && year - baseYear < dense.size() && present[year - baseYear]) {
+		return &dense[year - baseYear];
+	}
+	return nullptr;
+}
+
+/*
+	tryGetValue(year, value)
+	Sets value to the reading for a year and returns true, or returns false
+	if there is none.
+
+	@example
+		double value;
+		if (measure.tryGetValue(2010, value)) {
+			...
+		}
+*/
+const bool Measure::tryGetValue(const unsigned int year, double& value) const noexcept {
+	const double* found = findValue(year);
+	if (found == nullptr) {
+		return false;
+	}
+	value = *found;
+	return true;
 }
 
 /*
@@ -390,6 +537,10 @@ bool operator==(const Measure lhs, const Measure rhs) {
 		the map of values.
 */
 const std::map<unsigned int, double> Measure::getValues() const noexcept {
+	std::map<unsigned int, double> values;
+	forEachValue([&values](const unsigned int year, const double value) {
+		values.insert(values.end(), std::make_pair(year, value));
+	});
 	return values;
 }
 
@@ -406,9 +557,39 @@ const std::map<unsigned int, double> Measure::getValues() const noexcept {
 		The lhs Measure with the rhs data added.
 */
 Measure operator+(Measure lhs, const Measure& rhs) {
-	lhs.setLabel(rhs.getLabel());
-	for (auto it = rhs.values.begin(); it != rhs.values.end(); it++) {
-		lhs.setValue(it->first, it->second);	
-	}
+	lhs.merge(rhs);
 	return lhs;
 }
+
+/*
+	merge(other)
+	Add the label and values of other to this Measure in place, as operator+
+	does, with the values of other taking precedence.
+
+	@param other
+		The Measure to merge in to this one
+*/
+void Measure::merge(const Measure& other) {
+	label = other.label;
+	other.forEachValue([this](const unsigned int year, const double value) {
+		setValue(year, value);
+	});
+}
+
+/*
+	getMemoryUsage()
+	Estimate the memory used by this Measure: the object itself and its
+	readings. The codename and label are interned, so are counted by the Area
+	or Areas that hold the Measure rather than here.
+
+	@return
+		The approximate memory usage of the Measure
+*/
+const BethYw::MemoryUsage Measure::getMemoryUsage() const noexcept {
+	BethYw::MemoryUsage usage;
+	usage.measures = sizeof(Measure);
+	usage.values = dense.capacity() * sizeof(double)
+		+ (present.capacity() + 7) / 8
+		+ sparse.size() * (BethYw::MAP_NODE_OVERHEAD + sizeof(std::pair<const unsigned int, double>));
+	return usage;
+}
@@ -17,13 +17,26 @@
 #include <string>
 #include <map>
 #include <iostream>
+#include <vector>
 
 #include "lib_json.hpp"
+#include "arena.h"
+#include "memory.h"
+#include "symbols.h"
 using json = nlohmann::json;
 /*
     The Measure class contains a measure code, label, and a container for readings
     from across a number of years.
 
+    Readings are usually for a run of consecutive years, so they are stored
+    densely: a base year, an array of values for every year from the base year
+    on, and a bitmap of which of those years have a value. If the years become
+    widely scattered (e.g. 1900 and 2020 only), the readings are moved to a
+    sparse std::map instead.
+
+    The codename and label are interned (see symbols.h), as every Area has
+    its own copy of the same few Measures.
+
     TODO: Based on your implementation, there may be additional constructors
     or functions you implement here, and perhaps additional operators you may wish
     to overload.
@@ -31,24 +44,66 @@ using json = nlohmann::json;
 
 class Measure {
 private:
-	std::string codename;
-	std::string label;
-	std::map<unsigned int, double> values;
+	BethYw::Symbol codename;
+	BethYw::Symbol label;
+	unsigned int baseYear;
+	std::vector<double, BethYw::ArenaAllocator<double>> dense;
+	std::vector<bool, BethYw::ArenaAllocator<bool>> present;
+	std::map<unsigned int,
+		double,
+		std::less<unsigned int>,
+		BethYw::ArenaAllocator<std::pair<const unsigned int, double>>> sparse;
+	bool isSparse;
+	int count;
+
+	const bool fitsDense(const unsigned int first, const unsigned int last) const noexcept;
+	void makeSparse();
+	const double firstValue() const noexcept;
+	const double lastValue() const noexcept;
+
 public:
 	Measure(std::string code, const std::string &label);
+	Measure(const std::string& code, const std::string &label, std::shared_ptr<BethYw::Arena> arena);
+	Measure(const Measure& other) = default;
+	Measure(Measure&& other) = default;
 	~Measure() = default;
-	const std::string getCodename() const noexcept;
-	const std::string getLabel() const noexcept;
+	Measure& operator=(const Measure& other) = default;
+	Measure& operator=(Measure&& other) = default;
+	const std::string& getCodename() const noexcept;
+	const std::string& getLabel() const noexcept;
 	void setLabel(const std::string label);
 	const double getValue(const unsigned int key) const;
+	const double* findValue(const unsigned int year) const noexcept;
+	const bool tryGetValue(const unsigned int year, double& value) const noexcept;
 	void setValue(const unsigned int year, const double value);
 	const int size() const noexcept;
 	const double getDifference() const noexcept;
 	const double getDifferenceAsPercentage() const noexcept;
 	const double getAverage() const noexcept;
-	friend std::ostream &operator<<(std::ostream &output, const Measure measure);
-	friend bool operator==(const Measure lhs, const Measure rhs);
+	friend std::ostream &operator<<(std::ostream &output, const Measure& measure);
+	friend bool operator==(const Measure& lhs, const Measure& rhs);
 	const std::map<unsigned int, double> getValues() const noexcept;
+	/*
+	    Call fn(year, value) for every reading, in order of year. Unlike
+	    getValues(), this does not copy the readings.
+	*/
+	template <typename Fn>
+	void forEachValue(Fn fn) const {
+		if (isSparse) {
+			for (auto it = sparse.begin(); it != sparse.end(); it++) {
+				fn(it->first, it->second);
+			}
+		} else {
+			for (std::size_t i = 0; i < dense.size(); i++) {
+				if (present[i]) {
+					fn(baseYear + static_cast<unsigned int>(i), dense[i]);
+				}
+			}
+		}
+	}
+
+	void merge(const Measure& other);
+	const BethYw::MemoryUsage getMemoryUsage() const noexcept;
 	friend Measure operator+(Measure lhs, const Measure& rhs);
 };
 
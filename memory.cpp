@@ -0,0 +1,155 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of MemoryUsage and the helpers used
+    to estimate the memory footprint of Areas, Area and Measure.
+ */
+
+#include <iomanip>
+
+#include "memory.h"
+
+namespace {
+
+/*
+    Subtract b from a, or return 0 if b is larger.
+*/
+std::size_t saturatingSubtract(const std::size_t a, const std::size_t b) noexcept {
+	return a > b ? a - b : 0;
+}
+
+} // namespace
+
+/*
+    BethYw::MemoryUsage::MemoryUsage()
+
+    Construct a MemoryUsage of zero bytes.
+*/
+BethYw::MemoryUsage::MemoryUsage() noexcept
+	: names(0), measures(0), values(0), strings(0), overhead(0) {
+}
+
+/*
+	total()
+	Returns the sum of every part of the usage.
+*/
+const std::size_t BethYw::MemoryUsage::total() const noexcept {
+	return names + measures + values + strings + overhead;
+}
+
+/*
+	operator+=(other)
+	Add every part of other to this usage.
+*/
+BethYw::MemoryUsage& BethYw::MemoryUsage::operator+=(const MemoryUsage& other) noexcept {
+	names += other.names;
+	measures += other.measures;
+	values += other.values;
+	strings += other.strings;
+	overhead += other.overhead;
+	return *this;
+}
+
+/*
+    BethYw::MemoryUsage::since(before)
+
+    The growth in each part of the usage since an earlier measurement, or 0
+    for a part that has shrunk.
+
+    @param before
+        The earlier measurement
+
+    @return
+        The difference between this usage and before
+
+    @example
+        auto before = areas.getMemoryUsage();
+        ...
+        auto added = areas.getMemoryUsage().since(before);
+*/
+const BethYw::MemoryUsage BethYw::MemoryUsage::since(const MemoryUsage& before) const noexcept {
+	MemoryUsage difference;
+	difference.names = saturatingSubtract(names, before.names);
+	difference.measures = saturatingSubtract(measures, before.measures);
+	difference.values = saturatingSubtract(values, before.values);
+	difference.strings = saturatingSubtract(strings, before.strings);
+	difference.overhead = saturatingSubtract(overhead, before.overhead);
+	return difference;
+}
+
+/*
+    BethYw::stringHeapSize(str)
+
+    @return
+        The bytes a std::string has allocated outside of itself, which is none
+        for short strings held inside the object
+*/
+const std::size_t BethYw::stringHeapSize(const std::string& str) noexcept {
+	const char* data = str.data();
+	const char* object = reinterpret_cast<const char*>(&str);
+	if (data >= object && data < object + sizeof(std::string)) {
+		return 0;
+	}
+	return str.capacity() + 1;
+}
+
+/*
+    BethYw::internedStringSize(str)
+
+    @return
+        The bytes used by a string in the table of interned strings (see
+        symbols.h): the string and its entry in the table's index
+*/
+const std::size_t BethYw::internedStringSize(const std::string& str) noexcept {
+	const std::size_t indexEntry = sizeof(std::size_t) + 2 * sizeof(void*);
+	return sizeof(std::string) + stringHeapSize(str) + indexEntry;
+}
+
+/*
+    BethYw::printMemoryUsage(output, label, usage)
+
+    Print a line of a memory report: the label, then each part of the usage
+    and the total, in bytes.
+
+    @param output
+        The stream to print to
+
+    @param label
+        The name of what was measured, or an empty label to print the heading
+        of the report
+
+    @param usage
+        The usage to print
+
+    @example
+        BethYw::printMemoryUsage(std::cerr, "", BethYw::MemoryUsage());
+        BethYw::printMemoryUsage(std::cerr, "Total", areas.getMemoryUsage());
+*/
+void BethYw::printMemoryUsage(std::ostream& output, const std::string& label, const MemoryUsage& usage) {
+	const int labelWidth = 24;
+	const int width = 12;
+	if (label.empty()) {
+		output << std::left << std::setw(labelWidth) << "Memory (bytes)" << std::right
+			<< std::setw(width) << "Names"
+			<< std::setw(width) << "Measures"
+			<< std::setw(width) << "Values"
+			<< std::setw(width) << "Strings"
+			<< std::setw(width) << "Overhead"
+			<< std::setw(width) << "Total" << std::endl;
+		return;
+	}
+	output << std::left << std::setw(labelWidth) << label << std::right
+		<< std::setw(width) << usage.names
+		<< std::setw(width) << usage.measures
+		<< std::setw(width) << usage.values
+		<< std::setw(width) << usage.strings
+		<< std::setw(width) << usage.overhead
+		<< std::setw(width) << usage.total() << std::endl;
+}
@@ -0,0 +1,65 @@
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declaration of MemoryUsage, the approximate memory
+    footprint reported by Areas, Area and Measure, so the memory a load needs
+    can be measured and the effect of changes to how data is stored checked.
+
+    The figures are estimates: container nodes are counted as their contents
+    plus the pointers the Standard Library keeps with them, and the padding
+    added by the allocator is not counted.
+ */
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+namespace BethYw {
+
+/*
+    Bytes used, broken down by what they are used for.
+*/
+struct MemoryUsage {
+	// The names of Areas in each language
+	std::size_t names;
+
+	// Measure objects and the containers of Measures in each Area
+	std::size_t measures;
+
+	// The readings of each Measure
+	std::size_t values;
+
+	// The interned strings (codes, names and labels), each counted once
+	std::size_t strings;
+
+	// Area objects and the container of Areas
+	std::size_t overhead;
+
+	MemoryUsage() noexcept;
+	const std::size_t total() const noexcept;
+	MemoryUsage& operator+=(const MemoryUsage& other) noexcept;
+	const MemoryUsage since(const MemoryUsage& before) const noexcept;
+};
+
+/*
+    The bytes a std::map (a red-black tree) keeps in each node besides the
+    value: the colour and the parent, left and right pointers.
+*/
+constexpr std::size_t MAP_NODE_OVERHEAD = 4 * sizeof(void*);
+
+const std::size_t stringHeapSize(const std::string& str) noexcept;
+
+const std::size_t internedStringSize(const std::string& str) noexcept;
+
+void printMemoryUsage(std::ostream& output, const std::string& label, const MemoryUsage& usage);
+
+} // namespace BethYw
+
+#endif // MEMORY_H_
@@ -0,0 +1,260 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of the number decoding functions.
+
+    Decimal values are decoded with Clinger's fast path: if the digits fit
+    exactly in a double (at most 2^53) and the power of ten is small enough to
+    be exact too (10^22 or less), multiplying or dividing the two gives a
+    correctly rounded result. Anything else, such as values with more than 15
+    or so significant digits, is copied to a buffer on the stack and given to
+    std::strtod, which is correctly rounded but slower.
+
+    strtod uses the decimal point of the current C locale, which Beth Yw?
+    never changes from the default "C" locale.
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#include "numbers.h"
+
+namespace {
+
+/*
+    Powers of ten that can be represented exactly as a double.
+*/
+const double EXACT_POWERS_OF_TEN[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+constexpr int MAX_EXACT_POWER = 22;
+constexpr std::uint64_t MAX_EXACT_MANTISSA = std::uint64_t(1) << 53;
+
+/*
+    The longest number handed to strtod, longer numbers are reported as out of
+    range rather than allocating.
+*/
+constexpr std::size_t MAX_SLOW_PATH_LENGTH = 128;
+
+inline bool isDigit(const char c) noexcept {
+	return c >= '0' && c <= '9';
+}
+
+} // namespace
+
+/*
+    BethYw::parseNumber(first, last, value)
+
+    Decode an unsigned decimal integer, such as a year, from the characters in
+    [first, last). Only the digits 0-9 are accepted: no sign, whitespace or
+    hexadecimal prefix.
+
+    @param first
+        The first character to decode
+
+    @param last
+        One past the last character to decode
+
+    @param value
+        Set to the decoded number if decoding succeeds
+
+    @return
+        A NumberResult pointing to the first character after the number, and
+        NumberInvalid if there are no digits or NumberOutOfRange if the number
+        does not fit in an unsigned int
+
+    @example
+        unsigned int year;
+        auto result = BethYw::parseNumber(field.data, field.data + field.size, year);
+        if (result.error == BethYw::NumberOk) {
+            ...
+        }
+*/
+BethYw::NumberResult BethYw::parseNumber(const char* first,
+	const char* last,
+	unsigned int& value) noexcept {
+	const char* p = first;
+	std::uint64_t result = 0;
+	bool overflow = false;
+	while (p < last && isDigit(*p)) {
+		result = result * 10 + static_cast<unsigned int>(*p - '0');
+		if (result > std::numeric_limits<unsigned int>::max()) {
+			overflow = true;
+			result = 0;
+		}
+		p++;
+	}
+
+	if (p == first) {
+		return NumberResult{first, NumberInvalid};
+	} else if (overflow) {
+		return NumberResult{p, NumberOutOfRange};
+	}
+	value = static_cast<unsigned int>(result);
+	return NumberResult{p, NumberOk};
+}
+
+/*
+    BethYw::parseNumber(first, last, value)
+
+    Decode a decimal floating point number from the characters in
+    [first, last), in the format used by JSON and the CSV files: an optional
+    sign, digits with an optional decimal point, and an optional exponent
+    (e.g. -12.5e3). Infinity, NaN and hexadecimal values are not accepted.
+
+    @param first
+        The first character to decode
+
+    @param last
+        One past the last character to decode
+
+    @param value
+        Set to the decoded number if decoding succeeds
+
+    @return
+        A NumberResult pointing to the first character after the number, and
+        NumberInvalid if there is no number or NumberOutOfRange if it is too
+        large for a double
+
+    @example
+        double value;
+        auto result = BethYw::parseNumber(field.data, field.data + field.size, value);
+        if (result.error == BethYw::NumberOk) {
+            ...
+        }
+*/
+BethYw::NumberResult BethYw::parseNumber(const char* first,
+	const char* last,
+	double& value) noexcept {
+	const char* p = first;
+	bool negative = false;
+	if (p < last && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+
+	// Collect up to 19 significant digits, which always fit in 64 bits
+	std::uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool truncated = false;
+	bool anyDigits = false;
+	while (p < last && isDigit(*p)) {
+		anyDigits = true;
+		if (digits < 19) {
+			mantissa = mantissa * 10 + static_cast<unsigned int>(*p - '0');
+			if (mantissa != 0) {
+				digits++;
+			}
+		} else {
+			exponent++;
+			truncated = true;
+		}
+		p++;
+	}
+	if (p < last && *p == '.') {
+		p++;
+		while (p < last && isDigit(*p)) {
+			anyDigits = true;
+			if (digits < 19) {
+				mantissa = mantissa * 10 + static_cast<unsigned int>(*p - '0');
+				if (mantissa != 0) {
+					digits++;
+				}
+				exponent--;
+			} else {
+				truncated = true;
+			}
+			p++;
+		}
+	}
+	if (!anyDigits) {
+		return NumberResult{first, NumberInvalid};
+	}
+
+	// The exponent is only part of the number if it has digits
+	if (p < last && (*p == 'e' || *p == 'E')) {
+		const char* e = p + 1;
+		bool negativeExponent = false;
+		if (e < last && (*e == '-' || *e == '+')) {
+			negativeExponent = *e == '-';
+			e++;
+		}
+		if (e < last && isDigit(*e)) {
+			int explicitExponent = 0;
+			while (e < last && isDigit(*e)) {
+				if (explicitExponent < 100000) {
+					explicitExponent = explicitExponent * 10 + (*e - '0');
+				}
+				e++;
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			p = e;
+		}
+	}
+
+	if (!truncated && mantissa <= MAX_EXACT_MANTISSA &&
+		exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER) {
+		double result = static_cast<double>(mantissa);
+		if (exponent < 0) {
+			result /= EXACT_POWERS_OF_TEN[-exponent];
+		} else {
+			result *= EXACT_POWERS_OF_TEN[exponent];
+		}
+		value = negative ? -result : result;
+		return NumberResult{p, NumberOk};
+	}
+
+	// strtod needs a null-terminated copy, which is kept on the stack
+	std::size_t length = static_cast<std::size_t>(p - first);
+	if (length >= MAX_SLOW_PATH_LENGTH) {
+		return NumberResult{p, NumberOutOfRange};
+	}
+	char buffer[MAX_SLOW_PATH_LENGTH];
+	std::memcpy(buffer, first, length);
+	buffer[length] = '\0';
+
+	errno = 0;
+	double result = std::strtod(buffer, nullptr);
+	if (errno == ERANGE && std::isinf(result)) {
+		return NumberResult{p, NumberOutOfRange};
+	}
+	value = result;
+	return NumberResult{p, NumberOk};
+}
+
+/*
+    BethYw::parseWholeNumber(first, last, value)
+
+    Decode a number that takes up every character in [first, last), e.g. a
+    whole CSV field or JSON string.
+
+    @return
+        true if the characters are a valid number that is in range
+*/
+const bool BethYw::parseWholeNumber(const char* first,
+	const char* last,
+	unsigned int& value) noexcept {
+	NumberResult result = parseNumber(first, last, value);
+	return result.error == NumberOk && result.ptr == last;
+}
+
+const bool BethYw::parseWholeNumber(const char* first,
+	const char* last,
+	double& value) noexcept {
+	NumberResult result = parseNumber(first, last, value);
+	return result.error == NumberOk && result.ptr == last;
+}
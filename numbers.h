@@ -0,0 +1,53 @@
+#ifndef NUMBERS_H_
+#define NUMBERS_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains declarations for the functions that decode years and
+    values from the characters of a CSV field or JSON string.
+
+    Unlike std::stoul and std::stod, these work on a range of characters
+    (so the field does not need copying in to a std::string), do not depend on
+    the locale and do not throw, but report errors through the result, in the
+    style of C++17's std::from_chars.
+ */
+
+#include <cstddef>
+
+namespace BethYw {
+
+/*
+    The errors that can be reported when decoding a number.
+*/
+enum NumberError {
+  NumberOk,
+  NumberInvalid,
+  NumberOutOfRange
+};
+
+/*
+    The result of decoding a number: ptr points to the first character that
+    was not part of the number, and error says whether decoding succeeded.
+    If it did not, the value is left unchanged.
+*/
+struct NumberResult {
+	const char* ptr;
+	NumberError error;
+};
+
+NumberResult parseNumber(const char* first, const char* last, unsigned int& value) noexcept;
+
+NumberResult parseNumber(const char* first, const char* last, double& value) noexcept;
+
+const bool parseWholeNumber(const char* first, const char* last, unsigned int& value) noexcept;
+
+const bool parseWholeNumber(const char* first, const char* last, double& value) noexcept;
+
+} // namespace BethYw
+
+#endif // NUMBERS_H_
@@ -0,0 +1,396 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the structural scanning kernels. The vector kernels are
+    only compiled for x86 with GCC or Clang, and are built with the target
+    attribute so the rest of the program does not need -mavx2. On other
+    platforms only the scalar kernel is available.
+*/
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+#include "scan.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BETHYW_X86_SCAN 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/*
+    The kernel in use, or -1 if one has not been picked yet.
+*/
+std::atomic<int> currentKernel(-1);
+
+const char* findFirstOfScalar(const char* begin,
+	const char* end,
+	const BethYw::ByteSet& set) noexcept {
+	for (const char* p = begin; p < end; p++) {
+		if (set.contains(*p)) {
+			return p;
+		}
+	}
+	return end;
+}
+
+std::uint64_t matchBlockScalar(const char* block, const BethYw::ByteSet& set) noexcept {
+	std::uint64_t mask = 0;
+	for (std::size_t i = 0; i < BethYw::BLOCK_SIZE; i++) {
+		if (set.contains(block[i])) {
+			mask |= std::uint64_t(1) << i;
+		}
+	}
+	return mask;
+}
+
+#ifdef BETHYW_X86_SCAN
+
+__attribute__((target("sse4.2")))
+std::uint64_t matchBlockSSE42(const char* block, const BethYw::ByteSet& set) noexcept {
+	const __m128i needles = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.chars()));
+	const int needlesLength = static_cast<int>(set.size());
+	std::uint64_t mask = 0;
+	for (std::size_t i = 0; i < BethYw::BLOCK_SIZE; i += 16) {
+		__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+		__m128i bits = _mm_cmpestrm(needles, needlesLength, chunk, 16,
+			_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK);
+		mask |= static_cast<std::uint64_t>(_mm_cvtsi128_si32(bits) & 0xFFFF) << i;
+	}
+	return mask;
+}
+
+__attribute__((target("sse4.2")))
+const char* findFirstOfSSE42(const char* begin,
+	const char* end,
+	const BethYw::ByteSet& set) noexcept {
+	const __m128i needles = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.chars()));
+	const int needlesLength = static_cast<int>(set.size());
+	const char* p = begin;
+	while (end - p >= 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		int index = _mm_cmpestri(needles, needlesLength, block, 16,
+			_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+		if (index < 16) {
+			return p + index;
+		}
+		p += 16;
+	}
+	return findFirstOfScalar(p, end, set);
+}
+
+/*
+	Look up the nibbles of each byte in a 32 byte block and return a bit mask of
+	the positions that are in the set (see ByteSet).
+*/
+__attribute__((target("avx2")))
+inline unsigned int matchAVX2(const __m256i block,
+	const __m256i low,
+	const __m256i high) noexcept {
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	__m256i lowBits = _mm256_shuffle_epi8(low, _mm256_and_si256(block, nibble));
+	__m256i highBits = _mm256_shuffle_epi8(high,
+		_mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+	__m256i misses = _mm256_cmpeq_epi8(_mm256_and_si256(lowBits, highBits), _mm256_setzero_si256());
+	return ~static_cast<unsigned int>(_mm256_movemask_epi8(misses));
+}
+
+__attribute__((target("avx2")))
+const char* findFirstOfAVX2(const char* begin,
+	const char* end,
+	const BethYw::ByteSet& set) noexcept {
+	const __m256i low = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbles())));
+	const __m256i high = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbles())));
+
+	// Delimiters are often close together, so check one block before
+	// moving on to two at a time
+	const char* p = begin;
+	if (end - p >= 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		unsigned int mask = matchAVX2(block, low, high);
+		if (mask != 0) {
+			return p + __builtin_ctz(mask);
+		}
+		p += 32;
+	}
+	while (end - p >= 64) {
+		__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		__m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+		unsigned long long mask = matchAVX2(first, low, high) |
+			(static_cast<unsigned long long>(matchAVX2(second, low, high)) << 32);
+		if (mask != 0) {
+			return p + __builtin_ctzll(mask);
+		}
+		p += 64;
+	}
+	if (end - p >= 32) {
+		__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		unsigned int mask = matchAVX2(block, low, high);
+		if (mask != 0) {
+			return p + __builtin_ctz(mask);
+		}
+		p += 32;
+	}
+	return findFirstOfScalar(p, end, set);
+}
+
+__attribute__((target("avx2")))
+std::uint64_t matchBlockAVX2(const char* block, const BethYw::ByteSet& set) noexcept {
+	const __m256i low = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lowNibbles())));
+	const __m256i high = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.highNibbles())));
+	__m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+	__m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+	return matchAVX2(first, low, high) |
+		(static_cast<std::uint64_t>(matchAVX2(second, low, high)) << 32);
+}
+
+#endif // BETHYW_X86_SCAN
+
+/*
+	Pick the fastest kernel the processor supports.
+*/
+BethYw::ScanKernel bestKernel() noexcept {
+	if (BethYw::isScanKernelSupported(BethYw::AVX2Scan)) {
+		return BethYw::AVX2Scan;
+	} else if (BethYw::isScanKernelSupported(BethYw::SSE42Scan)) {
+		return BethYw::SSE42Scan;
+	}
+	return BethYw::ScalarScan;
+}
+
+} // namespace
+
+/*
+    BethYw::ByteSet::ByteSet(chars)
+
+    Construct a set of bytes to search for.
+
+    @param chars
+        A null-terminated string of up to 8 bytes to search for
+
+    @throws
+        std::invalid_argument if chars is empty or longer than 8 bytes
+
+    @example
+        BethYw::ByteSet delimiters(",\n\"");
+*/
+BethYw::ByteSet::ByteSet(const char* chars)
+	: set(), length(std::strlen(chars)), table(), low(), high() {
+	if (length == 0 || length > MAX_SIZE) {
+		throw std::invalid_argument("ByteSet: Must contain between 1 and 8 bytes");
+	}
+	for (std::size_t i = 0; i < length; i++) {
+		unsigned char c = static_cast<unsigned char>(chars[i]);
+		set[i] = chars[i];
+		table[c] = true;
+		low[c & 0x0F] |= 1 << i;
+		high[c >> 4] |= 1 << i;
+	}
+}
+
+/*
+	contains(c)
+	Returns true if c is in the set.
+*/
+const bool BethYw::ByteSet::contains(const char c) const noexcept {
+	return table[static_cast<unsigned char>(c)];
+}
+
+/*
+	size()
+	Returns the number of bytes in the set.
+*/
+const std::size_t BethYw::ByteSet::size() const noexcept {
+	return length;
+}
+
+/*
+	chars()
+	Returns the bytes in the set, padded with zeroes to 16 bytes.
+*/
+const char* BethYw::ByteSet::chars() const noexcept {
+	return set;
+}
+
+/*
+	lowNibbles()
+	Returns the bits of the bytes in the set, indexed by their low nibble.
+*/
+const unsigned char* BethYw::ByteSet::lowNibbles() const noexcept {
+	return low;
+}
+
+/*
+	highNibbles()
+	Returns the bits of the bytes in the set, indexed by their high nibble.
+*/
+const unsigned char* BethYw::ByteSet::highNibbles() const noexcept {
+	return high;
+}
+
+/*
+    BethYw::findFirstOf(begin, end, set)
+
+    Find the first byte in [begin, end) that is in set, using the fastest
+    kernel available (see scanKernel()).
+
+    @param begin
+        Start of the memory to search
+
+    @param end
+        End of the memory to search
+
+    @param set
+        The bytes to search for
+
+    @return
+        A pointer to the first matching byte, or end if there is none
+
+    @example
+        BethYw::ByteSet delimiters(",\n");
+        const char* p = BethYw::findFirstOf(data, data + size, delimiters);
+*/
+const char* BethYw::findFirstOf(const char* begin, const char* end, const ByteSet& set) noexcept {
+	return findFirstOf(begin, end, set, scanKernel());
+}
+
+/*
+    BethYw::findFirstOf(begin, end, set, kernel)
+
+    As above, using a specific kernel. If the kernel is not supported by the
+    processor, the scalar kernel is used.
+*/
+const char* BethYw::findFirstOf(const char* begin,
+	const char* end,
+	const ByteSet& set,
+	const ScanKernel kernel) noexcept {
+#ifdef BETHYW_X86_SCAN
+	if (kernel == AVX2Scan && isScanKernelSupported(AVX2Scan)) {
+		return findFirstOfAVX2(begin, end, set);
+	} else if (kernel == SSE42Scan && isScanKernelSupported(SSE42Scan)) {
+		return findFirstOfSSE42(begin, end, set);
+	}
+#endif
+	return findFirstOfScalar(begin, end, set);
+}
+
+/*
+    BethYw::matchBlock(block, set)
+
+    Find every byte in a block of BLOCK_SIZE (64) bytes that is in set, using
+    the fastest kernel available (see scanKernel()). The block must have 64
+    readable bytes, so the end of a buffer should be copied to a padded block
+    first.
+
+    @param block
+        Start of the 64 bytes to search
+
+    @param set
+        The bytes to search for
+
+    @return
+        A mask with bit i set if block[i] is in set
+
+    @example
+        BethYw::ByteSet delimiters(",\n");
+        std::uint64_t mask = BethYw::matchBlock(data, delimiters);
+        while (mask != 0) {
+            std::size_t i = BethYw::nextMatch(mask);
+            ...
+        }
+*/
+const std::uint64_t BethYw::matchBlock(const char* block, const ByteSet& set) noexcept {
+	return matchBlock(block, set, scanKernel());
+}
+
+/*
+    BethYw::matchBlock(block, set, kernel)
+
+    As above, using a specific kernel. If the kernel is not supported by the
+    processor, the scalar kernel is used.
+*/
+const std::uint64_t BethYw::matchBlock(const char* block,
+	const ByteSet& set,
+	const ScanKernel kernel) noexcept {
+#ifdef BETHYW_X86_SCAN
+	if (kernel == AVX2Scan && isScanKernelSupported(AVX2Scan)) {
+		return matchBlockAVX2(block, set);
+	} else if (kernel == SSE42Scan && isScanKernelSupported(SSE42Scan)) {
+		return matchBlockSSE42(block, set);
+	}
+#endif
+	return matchBlockScalar(block, set);
+}
+
+/*
+    BethYw::scanKernel()
+
+    @return
+        The kernel used by findFirstOf(), which is the fastest one supported
+        by the processor unless changed with setScanKernel()
+*/
+BethYw::ScanKernel BethYw::scanKernel() noexcept {
+	int kernel = currentKernel.load(std::memory_order_relaxed);
+	if (kernel < 0) {
+		kernel = bestKernel();
+		currentKernel.store(kernel, std::memory_order_relaxed);
+	}
+	return static_cast<ScanKernel>(kernel);
+}
+
+/*
+    BethYw::isScanKernelSupported(kernel)
+
+    @param kernel
+        The kernel to check
+
+    @return
+        true if the processor (and compiler) supports the kernel
+*/
+const bool BethYw::isScanKernelSupported(const ScanKernel kernel) noexcept {
+	if (kernel == ScalarScan) {
+		return true;
+	}
+#ifdef BETHYW_X86_SCAN
+	static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+	static const bool sse42 = (__builtin_cpu_init(), __builtin_cpu_supports("sse4.2"));
+	if (kernel == AVX2Scan) {
+		return avx2;
+	} else if (kernel == SSE42Scan) {
+		return sse42;
+	}
+#endif
+	return false;
+}
+
+/*
+    BethYw::setScanKernel(kernel)
+
+    Change the kernel used by findFirstOf(), e.g. to compare them.
+
+    @param kernel
+        The kernel to use
+
+    @return
+        false (and the kernel is left unchanged) if the kernel is not supported
+*/
+const bool BethYw::setScanKernel(const ScanKernel kernel) noexcept {
+	if (!isScanKernelSupported(kernel)) {
+		return false;
+	}
+	currentKernel.store(kernel, std::memory_order_relaxed);
+	return true;
+}
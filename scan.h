@@ -0,0 +1,111 @@
+#ifndef SCAN_H_
+#define SCAN_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains declarations for the structural scanning functions used
+    to find the next delimiter, quote, bracket etc. in a block of memory.
+
+    findFirstOf() suits sparse delimiters, such as line breaks, and is used
+    by CsvReader. matchBlock() returns a bit mask of every match in a 64 byte
+    block, which suits dense ones, such as the structure of a JSON document,
+    and is used by splitWelshStatsRows() to cut a StatsWales document in to
+    chunks of rows for a parallel parse. The rows themselves are still
+    decoded by the nlohmann::json parser a byte at a time.
+
+    There are three implementations (kernels): AVX2, which checks 32 or 64
+    bytes at a time, SSE4.2, which checks 16 bytes at a time, and a portable
+    scalar one that checks a byte at a time. The fastest one the processor
+    supports is picked the first time a scan is done.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BethYw {
+
+/*
+    The scanning implementations available.
+*/
+enum ScanKernel {
+  ScalarScan,
+  SSE42Scan,
+  AVX2Scan
+};
+
+/*
+    A small set of up to 8 bytes to search for, e.g. the CSV delimiters.
+*/
+class ByteSet {
+public:
+	ByteSet(const char* chars);
+	const bool contains(const char c) const noexcept;
+	const std::size_t size() const noexcept;
+	const char* chars() const noexcept;
+	const unsigned char* lowNibbles() const noexcept;
+	const unsigned char* highNibbles() const noexcept;
+
+	static constexpr std::size_t MAX_SIZE = 8;
+
+private:
+	char set[MAX_SIZE + 8];
+	std::size_t length;
+	bool table[256];
+
+	/*
+	    Each byte in the set is given its own bit, which is set in the entry
+	    for its low nibble in lowNibbles and its high nibble in highNibbles. A
+	    byte is in the set if the entries for its two nibbles share a bit,
+	    which lets the vector kernels look up 32 bytes at once with shuffles.
+	*/
+	unsigned char low[16];
+	unsigned char high[16];
+};
+
+const char* findFirstOf(const char* begin, const char* end, const ByteSet& set) noexcept;
+
+const char* findFirstOf(const char* begin,
+	const char* end,
+	const ByteSet& set,
+	const ScanKernel kernel) noexcept;
+
+constexpr std::size_t BLOCK_SIZE = 64;
+
+const std::uint64_t matchBlock(const char* block, const ByteSet& set) noexcept;
+
+const std::uint64_t matchBlock(const char* block,
+	const ByteSet& set,
+	const ScanKernel kernel) noexcept;
+
+/*
+    Remove the lowest set bit from a mask returned by matchBlock() and return
+    its position, i.e. the offset of the next match in the block. The mask must
+    not be zero.
+*/
+inline std::size_t nextMatch(std::uint64_t& mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+	std::size_t index = static_cast<std::size_t>(__builtin_ctzll(mask));
+#else
+	std::size_t index = 0;
+	while (!(mask & (std::uint64_t(1) << index))) {
+		index++;
+	}
+#endif
+	mask &= mask - 1;
+	return index;
+}
+
+ScanKernel scanKernel() noexcept;
+
+const bool isScanKernelSupported(const ScanKernel kernel) noexcept;
+
+const bool setScanKernel(const ScanKernel kernel) noexcept;
+
+} // namespace BethYw
+
+#endif // SCAN_H_
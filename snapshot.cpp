@@ -0,0 +1,451 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of the Snapshot class.
+
+    The file starts with a header (magic, version, byte order mark, the key
+    and the sources), followed by the areas, and ends with a hash of
+    everything before it. All integers are written in the byte order of the
+    machine that wrote the file; a snapshot from a machine with a different
+    byte order fails the byte order check and is rebuilt. Strings are written
+    as a 32 bit length followed by the bytes.
+
+        header    "BETHYWSS" VERSION 0x01020304 key
+                  <source count> (path size modified hash)...
+        areas     <area count> (code <name count> (lang name)...
+                  <measure count> (key codename label
+                  <value count> (year value)...)...)...
+        footer    <hash of everything above>
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include <sys/stat.h>
+
+#include "input.h"
+#include "snapshot.h"
+
+namespace {
+
+const char MAGIC[8] = {'B', 'E', 'T', 'H', 'Y', 'W', 'S', 'S'};
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+constexpr std::uint64_t HASH_OFFSET = 14695981039346656037ULL;
+constexpr std::uint64_t HASH_PRIME = 1099511628211ULL;
+
+/*
+	hashBytes(hash, data, size)
+	Continue an FNV-1a hash over a block of bytes. Whole 8 byte words are
+	mixed in at a time, which is several times faster than a byte at a time
+	and plenty for spotting a changed file.
+*/
+std::uint64_t hashBytes(std::uint64_t hash, const char* data, std::size_t size) noexcept {
+	std::size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		hash = (hash ^ word) * HASH_PRIME;
+	}
+	for (; i < size; i++) {
+		hash = (hash ^ static_cast<unsigned char>(data[i])) * HASH_PRIME;
+	}
+	return hash;
+}
+
+/*
+    Writes the snapshot in to a buffer, which is written to disk in one go.
+*/
+class SnapshotWriter {
+public:
+	std::string bytes;
+
+	template <typename T>
+	void write(const T value) {
+		bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void write(const std::string& value) {
+		write(static_cast<std::uint32_t>(value.size()));
+		bytes.append(value);
+	}
+};
+
+/*
+	writeSnapshotFile(path, bytes)
+	Write a snapshot under a temporary name and then rename it over path, so
+	a snapshot that is being written is never loaded by another run. Returns
+	false if it could not be written.
+*/
+bool writeSnapshotFile(const std::string& path, const std::string& bytes) {
+	const std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+		file.write(bytes.data(), bytes.size());
+		if (!file.good()) {
+			file.close();
+			std::remove(temporary.c_str());
+			return false;
+		}
+	}
+#ifdef _WIN32
+	// rename() does not replace an existing file on Windows
+	std::remove(path.c_str());
+#endif
+	if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+
+/*
+    Reads a snapshot out of memory. Every read is bounds checked, and returns
+    false rather than reading past the end of a truncated or corrupt file.
+*/
+class SnapshotReader {
+public:
+	SnapshotReader(const char* data, std::size_t size) : data(data), size(size), pos(0) {
+	}
+
+	template <typename T>
+	bool read(T& value) noexcept {
+		if (size - pos < sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&value, data + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	bool read(std::string& value) {
+		std::uint32_t length;
+		if (!read(length) || size - pos < length) {
+			return false;
+		}
+		value.assign(data + pos, length);
+		pos += length;
+		return true;
+	}
+
+	std::size_t position() const noexcept {
+		return pos;
+	}
+
+private:
+	const char* data;
+	std::size_t size;
+	std::size_t pos;
+};
+
+} // namespace
+
+/*
+    BethYw::statSource(path, source)
+
+    Fill in the path, size and modification time of a source file. The hash
+    is not calculated (see hashSource()).
+
+    @param path
+        The path of the file
+
+    @param source
+        The SnapshotSource to fill in
+
+    @return
+        false if the file does not exist
+*/
+const bool BethYw::statSource(const std::string& path, SnapshotSource& source) {
+	struct stat info;
+	if (::stat(path.c_str(), &info) != 0) {
+		return false;
+	}
+	source.path = path;
+	source.size = static_cast<std::uint64_t>(info.st_size);
+#ifdef __linux__
+	source.modified = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#else
+	source.modified = static_cast<std::int64_t>(info.st_mtime) * 1000000000;
+#endif
+	source.hash = 0;
+	return true;
+}
+
+/*
+    BethYw::hashSource(path)
+
+    Hash the contents of a source file, reading it through a memory mapping.
+
+    @param path
+        The path of the file
+
+    @return
+        A 64 bit hash of the contents of the file
+
+    @throws
+        std::runtime_error if the file cannot be opened
+*/
+const std::uint64_t BethYw::hashSource(const std::string& path) {
+	InputMappedFile input(path);
+	input.open();
+	return hashBytes(HASH_OFFSET, input.data(), input.size());
+}
+
+/*
+    BethYw::Snapshot::Snapshot(path)
+
+    Construct a snapshot stored at the given path. Nothing is read or written
+    until load() or save() is called.
+
+    @param path
+        The path of the snapshot file
+
+    @example
+        BethYw::Snapshot snapshot("bethyw.snapshot");
+*/
+BethYw::Snapshot::Snapshot(const std::string& path) : path(path) {
+}
+
+/*
+    BethYw::Snapshot::getPath()
+
+    @return
+        The path of the snapshot file
+*/
+const std::string BethYw::Snapshot::getPath() const {
+	return path;
+}
+
+/*
+    BethYw::Snapshot::load(areas, key, sources)
+
+    Load the snapshot in to areas, if the snapshot exists, was written by this
+    version, was built with the same key and from the same source files, and
+    none of the source files have changed since.
+
+    If a source file's modification time has changed but its contents have
+    not, the snapshot is rewritten with the new modification time, so the
+    file is only hashed once after being touched.
+
+    @param areas
+        The Areas instance to load in to, which should be empty. It is only
+        changed if the snapshot is loaded.
+
+    @param key
+        A description of everything other than the source files that the
+        contents of the snapshot depend on, e.g. the filters used
+
+    @param sources
+        The paths of the source files that would be parsed
+
+    @return
+        true if the snapshot was loaded, false if the datasets need parsing
+
+    @example
+        BethYw::Snapshot snapshot("bethyw.snapshot");
+        if (!snapshot.load(areas, key, sources)) {
+            ...
+            snapshot.save(areas, key, sources);
+        }
+*/
+const bool BethYw::Snapshot::load(Areas& areas,
+	const std::string& key,
+	const std::vector<std::string>& sources) const {
+	InputMappedFile input(path);
+	try {
+		input.open();
+	} catch (const std::runtime_error& e) {
+		return false;
+	}
+
+	// Check the footer before reading anything else
+	std::uint64_t footer;
+	if (input.size() < sizeof(MAGIC) + sizeof(footer)) {
+		return false;
+	}
+	std::size_t bodySize = input.size() - sizeof(footer);
+	std::memcpy(&footer, input.data() + bodySize, sizeof(footer));
+	if (footer != hashBytes(HASH_OFFSET, input.data(), bodySize) ||
+		std::memcmp(input.data(), MAGIC, sizeof(MAGIC)) != 0) {
+		return false;
+	}
+
+	SnapshotReader reader(input.data() + sizeof(MAGIC), bodySize - sizeof(MAGIC));
+	std::uint32_t version, byteOrder, count;
+	std::string snapshotKey;
+	if (!reader.read(version) || version != VERSION ||
+		!reader.read(byteOrder) || byteOrder != BYTE_ORDER_MARK ||
+		!reader.read(snapshotKey) || snapshotKey != key ||
+		!reader.read(count) || count != sources.size()) {
+		return false;
+	}
+
+	// The offsets in the file of the modification times of sources that have
+	// been touched but not changed, and their new modification times
+	std::vector<std::pair<std::size_t, std::int64_t>> touched;
+	for (std::uint32_t i = 0; i < count; i++) {
+		SnapshotSource recorded, current;
+		if (!reader.read(recorded.path) || recorded.path != sources[i] ||
+			!reader.read(recorded.size)) {
+			return false;
+		}
+		const std::size_t modifiedOffset = sizeof(MAGIC) + reader.position();
+		if (!reader.read(recorded.modified) || !reader.read(recorded.hash) ||
+			!statSource(sources[i], current) || current.size != recorded.size) {
+			return false;
+		}
+		if (current.modified != recorded.modified) {
+			if (hashSource(sources[i]) != recorded.hash) {
+				return false;
+			}
+			touched.push_back(std::make_pair(modifiedOffset, current.modified));
+		}
+	}
+
+	AreasContainer loaded(areas.areas.get_allocator());
+	std::uint32_t numAreas;
+	if (!reader.read(numAreas)) {
+		return false;
+	}
+	for (std::uint32_t i = 0; i < numAreas; i++) {
+		std::string code;
+		std::uint32_t numNames, numMeasures;
+		if (!reader.read(code) || !reader.read(numNames)) {
+			return false;
+		}
+		Area area(code, areas.getArena());
+		for (std::uint32_t j = 0; j < numNames; j++) {
+			std::string lang, name;
+			if (!reader.read(lang) || !reader.read(name)) {
+				return false;
+			}
+			area.setName(lang, name);
+		}
+
+		if (!reader.read(numMeasures)) {
+			return false;
+		}
+		for (std::uint32_t j = 0; j < numMeasures; j++) {
+			std::string measureKey, codename, label;
+			std::uint32_t numValues;
+			if (!reader.read(measureKey) || !reader.read(codename) ||
+				!reader.read(label) || !reader.read(numValues)) {
+				return false;
+			}
+			Measure measure(codename, label, areas.getArena());
+			for (std::uint32_t k = 0; k < numValues; k++) {
+				std::uint32_t year;
+				double value;
+				if (!reader.read(year) || !reader.read(value)) {
+					return false;
+				}
+				measure.setValue(year, value);
+			}
+			area.setMeasure(measureKey, std::move(measure));
+		}
+		loaded.insert(std::make_pair(BethYw::AuthorityCode::parse(code), std::move(area)));
+	}
+
+	areas.areas.swap(loaded);
+
+	// Record the new modification times of touched sources, so later runs
+	// trust them again without hashing them. Only those fields and the footer
+	// change. The snapshot has been loaded either way, so if it cannot be
+	// rewritten the sources are simply hashed again next time.
+	if (!touched.empty()) {
+		SnapshotWriter writer;
+		writer.bytes.assign(input.data(), bodySize);
+		for (auto it = touched.begin(); it != touched.end(); it++) {
+			std::memcpy(&writer.bytes[it->first], &it->second, sizeof(it->second));
+		}
+		writer.write(hashBytes(HASH_OFFSET, writer.bytes.data(), writer.bytes.size()));
+		writeSnapshotFile(path, writer.bytes);
+	}
+	return true;
+}
+
+/*
+    BethYw::Snapshot::save(areas, key, sources)
+
+    Save areas to the snapshot file, replacing any snapshot already there.
+    The file is written under a temporary name and then renamed (see
+    writeSnapshotFile()).
+
+    @param areas
+        The Areas instance to save
+
+    @param key
+        A description of everything other than the source files that the
+        contents of the snapshot depend on (see load())
+
+    @param sources
+        The paths of the source files that areas was populated from
+
+    @throws
+        std::runtime_error if a source file is missing or the snapshot cannot
+        be written
+*/
+void BethYw::Snapshot::save(const Areas& areas,
+	const std::string& key,
+	const std::vector<std::string>& sources) const {
+	SnapshotWriter writer;
+	writer.bytes.append(MAGIC, sizeof(MAGIC));
+	writer.write(VERSION);
+	writer.write(BYTE_ORDER_MARK);
+	writer.write(key);
+
+	writer.write(static_cast<std::uint32_t>(sources.size()));
+	for (auto& sourcePath : sources) {
+		SnapshotSource source;
+		if (!statSource(sourcePath, source)) {
+			throw std::runtime_error("Snapshot::save: Source file is missing " + sourcePath);
+		}
+		writer.write(source.path);
+		writer.write(source.size);
+		writer.write(source.modified);
+		writer.write(hashSource(sourcePath));
+	}
+
+	writer.write(static_cast<std::uint32_t>(areas.areas.size()));
+	areas.forEachArea([&writer](const Area& area) {
+		writer.write(area.getLocalAuthorityCode());
+
+		std::uint32_t numNames = 0;
+		area.forEachName([&numNames](const std::string&, const std::string&) {
+			numNames++;
+		});
+		writer.write(numNames);
+		area.forEachName([&writer](const std::string& lang, const std::string& name) {
+			writer.write(lang);
+			writer.write(name);
+		});
+
+		writer.write(static_cast<std::uint32_t>(area.size()));
+		area.forEachMeasure([&writer](const std::string& codename, const Measure& measure) {
+			writer.write(codename);
+			writer.write(measure.getCodename());
+			writer.write(measure.getLabel());
+
+			writer.write(static_cast<std::uint32_t>(measure.size()));
+			measure.forEachValue([&writer](const unsigned int year, const double value) {
+				writer.write(static_cast<std::uint32_t>(year));
+				writer.write(value);
+			});
+		});
+	});
+	writer.write(hashBytes(HASH_OFFSET, writer.bytes.data(), writer.bytes.size()));
+
+	if (!writeSnapshotFile(path, writer.bytes)) {
+		throw std::runtime_error("Snapshot::save: Failed to write snapshot " + path);
+	}
+}
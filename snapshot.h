@@ -0,0 +1,72 @@
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declaration of the Snapshot class, which saves a
+    populated Areas instance to a compact binary file and loads it back, so
+    that later runs with the same arguments and unchanged source files can
+    skip parsing the datasets altogether.
+
+    A snapshot records every source file it was built from with its size,
+    modification time and a hash of its contents. When loading, a file whose
+    size and modification time are unchanged is trusted; if only the
+    modification time has changed, the contents are hashed and compared, so
+    touching a file does not make the snapshot stale. The new modification
+    time is then written back to the snapshot, so the file is not hashed
+    again on every later run.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "areas.h"
+
+namespace BethYw {
+
+/*
+    A source file that a snapshot was built from.
+*/
+struct SnapshotSource {
+	std::string path;
+	std::uint64_t size;
+	std::int64_t modified;
+	std::uint64_t hash;
+};
+
+class Snapshot {
+public:
+	/*
+	    Bumped whenever the layout of the file changes, so that snapshots
+	    written by older versions are rebuilt rather than misread.
+	*/
+	static constexpr std::uint32_t VERSION = 1;
+
+	Snapshot(const std::string& path);
+	~Snapshot() = default;
+
+	const std::string getPath() const;
+	const bool load(Areas& areas,
+		const std::string& key,
+		const std::vector<std::string>& sources) const;
+	void save(const Areas& areas,
+		const std::string& key,
+		const std::vector<std::string>& sources) const;
+
+private:
+	std::string path;
+};
+
+const bool statSource(const std::string& path, SnapshotSource& source);
+
+const std::uint64_t hashSource(const std::string& path);
+
+} // namespace BethYw
+
+#endif // SNAPSHOT_H_
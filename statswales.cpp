@@ -0,0 +1,646 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of the WelshStatsHandler class. The
+    nlohmann::json SAX parser calls one of these functions for every token in
+    the file. We keep track of how deep we are in the document so we know when
+    we are inside a row of the top-level "value" array:
+
+        {                                   depth 1
+          "odata.metadata": "...",
+          "value": [                        depth 2
+            { "Data": 1.0, ... },           depth 3, one row
+            ...
+          ],
+          "odata.nextLink": "..."
+        }
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "numbers.h"
+#include "scan.h"
+#include "statswales.h"
+
+namespace {
+
+/*
+    The bytes that make up the structure of a JSON document, which
+    splitWelshStatsRows() finds a block at a time.
+*/
+const BethYw::ByteSet STRUCTURAL_BYTES("\"\\{}[],");
+
+/*
+    An iterator over a chunk of rows that adds the enclosing brackets, so that
+    the chunk can be given to the JSON parser as an array without copying it.
+*/
+class BracketedIterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = char;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const char*;
+	using reference = char;
+
+	BracketedIterator(const char* data, std::size_t size, std::size_t pos)
+		: data(data), size(size), pos(pos) {
+	}
+
+	char operator*() const {
+		if (pos == 0) {
+			return '[';
+		} else if (pos > size) {
+			return ']';
+		}
+		return data[pos - 1];
+	}
+
+	BracketedIterator& operator++() {
+		pos++;
+		return *this;
+	}
+
+	BracketedIterator operator++(int) {
+		BracketedIterator it = *this;
+		pos++;
+		return it;
+	}
+
+	bool operator==(const BracketedIterator& rhs) const {
+		return pos == rhs.pos;
+	}
+
+	bool operator!=(const BracketedIterator& rhs) const {
+		return pos != rhs.pos;
+	}
+
+private:
+	const char* data;
+	std::size_t size;
+	std::size_t pos;
+};
+
+} // namespace
+
+/*
+    WelshStatsHandler::WelshStatsHandler(cols, onRow)
+
+    Construct a handler for a StatsWales file with the column names in cols.
+
+    @param cols
+        A map of the enum BethyYw::SourceColumnMapping (see datasets.h) to
+        strings that give the key names in the JSON file
+
+    @param onRow
+        Function called with every complete row in the "value" array
+
+    @throws
+        std::out_of_range if there are not enough columns in cols
+
+    @example
+        WelshStatsHandler handler(cols, [](const WelshStatsRow& row) {
+            // do stuff here...
+        });
+        handler.parse(is);
+*/
+WelshStatsHandler::WelshStatsHandler(
+	const BethYw::SourceColumnMapping& cols,
+	RowCallback onRow)
+	: WelshStatsHandler(cols, std::move(onRow), nullptr) {
+}
+
+/*
+    WelshStatsHandler::WelshStatsHandler(cols, onRow, keepRow)
+
+    Construct a handler as above that also checks each row with keepRow as it
+    is read, so rows that are not needed (e.g. outside the years filter) are
+    skipped before all of their fields are copied.
+
+    @param cols
+        A map of the enum BethyYw::SourceColumnMapping (see datasets.h) to
+        strings that give the key names in the JSON file
+
+    @param onRow
+        Function called with every complete row that keepRow did not reject
+
+    @param keepRow
+        Function called with the fields of a row read so far, or nullptr to
+        keep every row
+
+    @throws
+        std::out_of_range if there are not enough columns in cols
+
+    @example
+        WelshStatsHandler handler(cols,
+            [](const WelshStatsRow& row) {
+                // do stuff here...
+            },
+            [](const WelshStatsRow& row, const unsigned int read) {
+                return !(read & WelshStatsHandler::YEAR) || row.year >= 2000;
+            });
+        handler.parse(is);
+*/
+WelshStatsHandler::WelshStatsHandler(
+	const BethYw::SourceColumnMapping& cols,
+	RowCallback onRow,
+	RowPredicate keepRow)
+	: required(AUTH_CODE | AUTH_NAME | MEASURE_CODE | MEASURE_NAME | YEAR | VALUE),
+	fixed(0), seen(0), current(0), depth(0), inValue(false), nextIsValue(false),
+	topLevelKeys(false), skipping(false), row(), onRow(std::move(onRow)),
+	keepRow(std::move(keepRow)) {
+
+	std::vector<std::pair<BethYw::SourceColumn, unsigned int>> fields = {
+		{BethYw::AUTH_CODE, AUTH_CODE},
+		{BethYw::AUTH_NAME_ENG, AUTH_NAME},
+		{BethYw::YEAR, YEAR},
+		{BethYw::VALUE, VALUE}
+	};
+	if (cols.count(BethYw::MEASURE_CODE)) {
+		fields.push_back({BethYw::MEASURE_CODE, MEASURE_CODE});
+		fields.push_back({BethYw::MEASURE_NAME, MEASURE_NAME});
+	} else {
+		row.measureCode = cols.at(BethYw::SINGLE_MEASURE_CODE);
+		row.measureName = cols.at(BethYw::SINGLE_MEASURE_NAME);
+		required &= ~(MEASURE_CODE | MEASURE_NAME);
+		fixed = MEASURE_CODE | MEASURE_NAME;
+	}
+
+	for (auto it = fields.begin(); it != fields.end(); it++) {
+		const std::string& name = cols.at(it->first);
+		bool found = false;
+		for (auto itK = keys.begin(); itK != keys.end(); itK++) {
+			if (itK->first == name) {
+				itK->second |= it->second;
+				found = true;
+			}
+		}
+		if (!found) {
+			keys.push_back(std::make_pair(name, it->second));
+		}
+	}
+	row.year = 0;
+	row.value = 0;
+}
+
+/*
+	hasData()
+	Returns true if the top-level object had at least one key.
+*/
+const bool WelshStatsHandler::hasData() const noexcept {
+	return topLevelKeys;
+}
+
+/*
+	parse(is)
+	Parse a whole StatsWales document from a stream. Returns false if the
+	document is malformed.
+*/
+bool WelshStatsHandler::parse(std::istream& is) {
+	return nlohmann::json::sax_parse(is, this);
+}
+
+/*
+	parse(data, size)
+	Parse a whole StatsWales document held in memory. Returns false if the
+	document is malformed.
+*/
+bool WelshStatsHandler::parse(const char* data, std::size_t size) {
+	return nlohmann::json::sax_parse(data, data + size, this);
+}
+
+/*
+	parseRows(data, size)
+	Parse a chunk of rows from the "value" array (see splitWelshStatsRows()),
+	as if it were the whole array. Returns false if the chunk is malformed.
+*/
+bool WelshStatsHandler::parseRows(const char* data, std::size_t size) {
+	depth = 1;
+	nextIsValue = true;
+	topLevelKeys = true;
+	return nlohmann::json::sax_parse(
+		BracketedIterator(data, size, 0),
+		BracketedIterator(data, size, size + 2),
+		this);
+}
+
+/*
+	inRow()
+	Returns true if we are directly inside a row of the "value" array.
+*/
+const bool WelshStatsHandler::inRow() const noexcept {
+	return inValue && depth == 3;
+}
+
+/*
+	scalar()
+	Called for every scalar value. Values for keys at the top level are
+	skipped, and values inside a row are recorded as seen. Once a field that
+	keepRow checks has been read, keepRow decides if the rest of the row is
+	needed.
+*/
+bool WelshStatsHandler::scalar() {
+	if (depth == 1) {
+		nextIsValue = false;
+	}
+	const unsigned int field = current;
+	seen |= current;
+	current = 0;
+	if (!skipping && keepRow && (field & (AUTH_CODE | AUTH_NAME | MEASURE_CODE | YEAR))) {
+		skipping = !keepRow(row, seen | fixed);
+	}
+	return true;
+}
+
+bool WelshStatsHandler::null() {
+	return current == 0 && scalar();
+}
+
+bool WelshStatsHandler::boolean(bool) {
+	return current == 0 && scalar();
+}
+
+bool WelshStatsHandler::binary(nlohmann::json::binary_t&) {
+	return current == 0 && scalar();
+}
+
+bool WelshStatsHandler::number_integer(nlohmann::json::number_integer_t val) {
+	if (current & (AUTH_CODE | AUTH_NAME | MEASURE_CODE | MEASURE_NAME)) {
+		return false;
+	}
+	if (current & YEAR) {
+		if (val < 0) {
+			return false;
+		}
+		row.year = static_cast<unsigned int>(val);
+	}
+	if (current & VALUE) {
+		row.value = static_cast<double>(val);
+	}
+	return scalar();
+}
+
+bool WelshStatsHandler::number_unsigned(nlohmann::json::number_unsigned_t val) {
+	if (current & (AUTH_CODE | AUTH_NAME | MEASURE_CODE | MEASURE_NAME)) {
+		return false;
+	}
+	if (current & YEAR) {
+		row.year = static_cast<unsigned int>(val);
+	}
+	if (current & VALUE) {
+		row.value = static_cast<double>(val);
+	}
+	return scalar();
+}
+
+bool WelshStatsHandler::number_float(nlohmann::json::number_float_t val,
+	const nlohmann::json::string_t&) {
+	if (current & ~VALUE) {
+		return false;
+	}
+	if (current & VALUE) {
+		row.value = val;
+	}
+	return scalar();
+}
+
+/*
+	string(val)
+	Years are stored as strings in StatsWales files, and some files also store
+	the values as strings, so these are converted here.
+*/
+bool WelshStatsHandler::string(nlohmann::json::string_t& val) {
+	if (current == 0) {
+		return scalar();
+	}
+	if (skipping) {
+		// The row is not needed, but a malformed year or value is still an
+		// error
+		const char* first = val.data();
+		const char* last = first + val.size();
+		unsigned int year;
+		double value;
+		if ((current & YEAR) && !BethYw::parseWholeNumber(first, last, year)) {
+			return false;
+		}
+		if ((current & VALUE) && !BethYw::parseWholeNumber(first, last, value)) {
+			return false;
+		}
+		return scalar();
+	}
+	if (current & AUTH_CODE) {
+		row.authCode = val;
+	}
+	if (current & AUTH_NAME) {
+		row.authName = val;
+	}
+	if (current & MEASURE_CODE) {
+		row.measureCode = val;
+	}
+	if (current & MEASURE_NAME) {
+		row.measureName = val;
+	}
+	const char* first = val.data();
+	const char* last = first + val.size();
+	if ((current & YEAR) && !BethYw::parseWholeNumber(first, last, row.year)) {
+		return false;
+	}
+	if ((current & VALUE) && !BethYw::parseWholeNumber(first, last, row.value)) {
+		return false;
+	}
+	return scalar();
+}
+
+bool WelshStatsHandler::start_object(std::size_t) {
+	if (current != 0) {
+		return false;
+	}
+	if (depth == 1) {
+		nextIsValue = false;
+	}
+	depth++;
+	if (inRow()) {
+		seen = 0;
+		skipping = false;
+	}
+	return true;
+}
+
+/*
+	key(val)
+	Work out which fields of the row (if any) the next value belongs to. The
+	key is only compared, never copied.
+*/
+bool WelshStatsHandler::key(nlohmann::json::string_t& val) {
+	current = 0;
+	if (depth == 1) {
+		topLevelKeys = true;
+		nextIsValue = (val == "value");
+	} else if (inRow()) {
+		for (auto it = keys.begin(); it != keys.end(); it++) {
+			if (it->first == val) {
+				current = it->second;
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+	end_object()
+	At the end of a row, check every mapped column was present and hand the
+	row on.
+*/
+bool WelshStatsHandler::end_object() {
+	if (inRow()) {
+		if ((seen & required) != required) {
+			return false;
+		}
+		if (!skipping) {
+			onRow(row);
+		}
+	}
+	depth--;
+	return true;
+}
+
+bool WelshStatsHandler::start_array(std::size_t) {
+	if (current != 0) {
+		return false;
+	}
+	depth++;
+	if (depth == 2 && nextIsValue) {
+		inValue = true;
+	}
+	nextIsValue = false;
+	return true;
+}
+
+bool WelshStatsHandler::end_array() {
+	if (depth == 2) {
+		inValue = false;
+	}
+	depth--;
+	return true;
+}
+
+bool WelshStatsHandler::parse_error(std::size_t,
+	const std::string&,
+	const nlohmann::detail::exception&) {
+	return false;
+}
+
+/*
+    splitWelshStatsRows(data, size, count, chunks, hasData)
+
+    Find the top-level "value" array in a StatsWales document held in memory,
+    and split it in to up to count chunks of roughly equal size. Chunks only
+    ever end between two rows, so every chunk can be parsed on its own with
+    WelshStatsHandler::parseRows(), and parsing the chunks in order gives the
+    rows in the same order as they are in the document.
+
+    This only looks at the structure of the document (strings, brackets and
+    commas), it does not check that the rows themselves are valid JSON.
+
+    @param data
+        Start of the document
+
+    @param size
+        Number of bytes in the document
+
+    @param count
+        The maximum number of chunks to split the rows in to
+
+    @param chunks
+        Filled with the chunks, in document order
+
+    @param hasData
+        Set to true if the top-level object has at least one key
+
+    @return
+        false if the brackets or strings in the document are unbalanced
+
+    @example
+        std::vector<WelshStatsChunk> chunks;
+        bool hasData;
+        if (splitWelshStatsRows(data, size, 4, chunks, hasData)) {
+            for (auto& chunk : chunks) {
+                handler.parseRows(data + chunk.first, chunk.second - chunk.first);
+            }
+        }
+*/
+bool splitWelshStatsRows(const char* data,
+	std::size_t size,
+	std::size_t count,
+	std::vector<WelshStatsChunk>& chunks,
+	bool& hasData) {
+	chunks.clear();
+	hasData = false;
+	if (count == 0) {
+		count = 1;
+	}
+
+	unsigned int depth = 0;
+	bool inString = false;
+	bool inValue = false;
+	bool foundValue = false;
+	std::size_t stringStart = 0;
+	std::size_t lastStart = 0;
+	std::size_t lastEnd = 0;
+	std::size_t chunkStart = 0;
+	std::size_t step = 0;
+	std::size_t target = 0;
+
+	// Positions before skip are escaped characters in a string
+	std::size_t skip = 0;
+	char padded[BethYw::BLOCK_SIZE];
+	for (std::size_t blockStart = 0; blockStart < size; blockStart += BethYw::BLOCK_SIZE) {
+		std::uint64_t mask;
+		if (size - blockStart >= BethYw::BLOCK_SIZE) {
+			mask = BethYw::matchBlock(data + blockStart, STRUCTURAL_BYTES);
+		} else {
+			std::memset(padded, ' ', BethYw::BLOCK_SIZE);
+			std::memcpy(padded, data + blockStart, size - blockStart);
+			mask = BethYw::matchBlock(padded, STRUCTURAL_BYTES);
+		}
+
+		while (mask != 0) {
+			std::size_t i = blockStart + BethYw::nextMatch(mask);
+			if (i < skip) {
+				continue;
+			}
+
+			char c = data[i];
+			if (inString) {
+				if (c == '\\') {
+					skip = i + 2;
+				} else if (c == '"') {
+					inString = false;
+					if (depth == 1) {
+						lastStart = stringStart;
+						lastEnd = i;
+						hasData = true;
+					}
+				}
+				continue;
+			}
+
+			if (c == '"') {
+				inString = true;
+				stringStart = i + 1;
+			} else if (c == '{' || c == '[') {
+				depth++;
+				if (c == '[' && depth == 2 && !foundValue &&
+					lastEnd - lastStart == 5 && std::memcmp(data + lastStart, "value", 5) == 0) {
+					foundValue = true;
+					inValue = true;
+					chunkStart = i + 1;
+					step = (size - chunkStart) / count;
+					target = chunkStart + step;
+				}
+			} else if (c == '}' || c == ']') {
+				if (depth == 0) {
+					return false;
+				}
+				if (c == ']' && depth == 2 && inValue) {
+					chunks.push_back(std::make_pair(chunkStart, i));
+					inValue = false;
+				}
+				depth--;
+			} else if (c == ',' && inValue && depth == 2 &&
+				i >= target && chunks.size() + 1 < count) {
+				chunks.push_back(std::make_pair(chunkStart, i));
+				chunkStart = i + 1;
+				target = chunkStart + step;
+			}
+		}
+	}
+
+	return depth == 0 && !inString;
+}
+
+/*
+    findWelshStatsNextLink(data, size)
+
+    Find the "odata.nextLink" of a StatsWales page held in memory. StatsWales
+    puts the link at the end of the page, after the "value" array, so only the
+    last few kilobytes are searched, which is much quicker than parsing the
+    page to find it.
+
+    @param data
+        Start of the page
+
+    @param size
+        Number of bytes in the page
+
+    @return
+        The URL of the next page, or an empty string if this is the last page
+
+    @example
+        std::string next = findWelshStatsNextLink(page.data(), page.size());
+        if (!next.empty()) {
+            ...
+        }
+*/
+std::string findWelshStatsNextLink(const char* data, std::size_t size) {
+	const std::size_t TAIL_SIZE = 8 * 1024;
+	const char KEY[] = "\"odata.nextLink\"";
+	const std::size_t keySize = sizeof(KEY) - 1;
+
+	std::size_t tailStart = size > TAIL_SIZE ? size - TAIL_SIZE : 0;
+	std::size_t keyStart = std::string::npos;
+	for (std::size_t i = size >= keySize ? size - keySize + 1 : 0; i-- > tailStart;) {
+		if (std::memcmp(data + i, KEY, keySize) == 0) {
+			keyStart = i;
+			break;
+		}
+	}
+	if (keyStart == std::string::npos) {
+		return "";
+	}
+
+	auto isSpace = [](const char c) {
+		return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+	};
+	std::size_t i = keyStart + keySize;
+	while (i < size && isSpace(data[i])) {
+		i++;
+	}
+	if (i >= size || data[i] != ':') {
+		return "";
+	}
+	i++;
+	while (i < size && isSpace(data[i])) {
+		i++;
+	}
+	if (i >= size || data[i] != '"') {
+		return "";
+	}
+	i++;
+
+	// URLs only need the simple escapes, e.g. "\/"
+	std::string link;
+	while (i < size && data[i] != '"') {
+		if (data[i] == '\\') {
+			i++;
+			if (i >= size) {
+				return "";
+			}
+		}
+		link += data[i];
+		i++;
+	}
+	return i < size ? link : "";
+}
@@ -0,0 +1,146 @@
+#ifndef STATSWALES_H_
+#define STATSWALES_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declaration of the WelshStatsHandler class, a SAX
+    event handler for the nlohmann::json library that reads StatsWales JSON
+    files one row at a time instead of building the whole document in memory.
+
+    Only the keys named in the SourceColumnMapping are kept, everything else
+    in a row is skipped over without being copied. A RowPredicate can also
+    reject a row part way through, from the fields read so far (e.g. its
+    year), after which the rest of the row is not copied either.
+
+    For large files held in memory, splitWelshStatsRows() cuts the "value"
+    array in to chunks of whole rows, which can then be parsed on separate
+    threads with WelshStatsHandler::parseRows().
+
+    StatsWales splits large datasets in to pages, each of which ends with an
+    "odata.nextLink" to the next page. findWelshStatsNextLink() reads this
+    link without parsing the page.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lib_json.hpp"
+#include "datasets.h"
+
+/*
+    A single row of the "value" array of a StatsWales file, reduced to the
+    columns Beth Yw? cares about. The strings are reused between rows so they
+    keep their capacity.
+*/
+struct WelshStatsRow {
+	std::string authCode;
+	std::string authName;
+	std::string measureCode;
+	std::string measureName;
+	unsigned int year;
+	double value;
+};
+
+/*
+    SAX handler passed to nlohmann::json::sax_parse(). Each complete row is
+    handed to the callback given in the constructor, after which the row is
+    cleared for the next one, so memory use is bounded by one row.
+
+    Every callback returns false on a malformed document, which makes
+    sax_parse() stop and return false.
+*/
+class WelshStatsHandler {
+public:
+	/*
+	    Bit flags for the row fields, a single JSON key may fill more than one
+	    field (e.g. the AQI dataset uses the same key for a measure's code and
+	    name).
+	*/
+	enum Field : unsigned int {
+		AUTH_CODE    = 1 << 0,
+		AUTH_NAME    = 1 << 1,
+		MEASURE_CODE = 1 << 2,
+		MEASURE_NAME = 1 << 3,
+		YEAR         = 1 << 4,
+		VALUE        = 1 << 5
+	};
+
+	using RowCallback = std::function<void(const WelshStatsRow& row)>;
+
+	/*
+	    Called after the area code, area name, measure code or year of a row
+	    is read, with the Fields of the row read so far (a dataset's single
+	    measure counts as read). Fields not yet read hold stale values. If it
+	    returns false, the rest of the row is checked but not copied, and the
+	    row is not handed to the RowCallback.
+	*/
+	using RowPredicate = std::function<bool(const WelshStatsRow& row, const unsigned int read)>;
+
+	WelshStatsHandler(const BethYw::SourceColumnMapping& cols, RowCallback onRow);
+	WelshStatsHandler(const BethYw::SourceColumnMapping& cols, RowCallback onRow, RowPredicate keepRow);
+	~WelshStatsHandler() = default;
+
+	const bool hasData() const noexcept;
+	bool parse(std::istream& is);
+	bool parse(const char* data, std::size_t size);
+	bool parseRows(const char* data, std::size_t size);
+
+	bool null();
+	bool boolean(bool val);
+	bool number_integer(nlohmann::json::number_integer_t val);
+	bool number_unsigned(nlohmann::json::number_unsigned_t val);
+	bool number_float(nlohmann::json::number_float_t val, const nlohmann::json::string_t& s);
+	bool string(nlohmann::json::string_t& val);
+	bool binary(nlohmann::json::binary_t& val);
+	bool start_object(std::size_t elements);
+	bool key(nlohmann::json::string_t& val);
+	bool end_object();
+	bool start_array(std::size_t elements);
+	bool end_array();
+	bool parse_error(std::size_t position,
+		const std::string& lastToken,
+		const nlohmann::detail::exception& ex);
+
+private:
+	std::vector<std::pair<std::string, unsigned int>> keys;
+	unsigned int required;
+	unsigned int fixed;
+	unsigned int seen;
+	unsigned int current;
+	unsigned int depth;
+	bool inValue;
+	bool nextIsValue;
+	bool topLevelKeys;
+	bool skipping;
+	WelshStatsRow row;
+	RowCallback onRow;
+	RowPredicate keepRow;
+
+	const bool inRow() const noexcept;
+	bool scalar();
+};
+
+/*
+    A range [first, second) of a StatsWales document that holds whole rows of
+    the "value" array separated by commas, without the enclosing brackets.
+*/
+using WelshStatsChunk = std::pair<std::size_t, std::size_t>;
+
+bool splitWelshStatsRows(const char* data,
+	std::size_t size,
+	std::size_t count,
+	std::vector<WelshStatsChunk>& chunks,
+	bool& hasData);
+
+std::string findWelshStatsNextLink(const char* data, std::size_t size);
+
+#endif // STATSWALES_H_
@@ -0,0 +1,333 @@
+
+
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the implementation of Symbol and the process-wide
+    table of interned strings.
+
+    The strings are kept in a std::deque, which never moves its elements, so
+    a Symbol can point straight at its string. They are indexed by a hash of
+    their characters, which lets a string be looked up from a pointer and
+    length (e.g. a CSV field) without building a std::string first.
+
+    Every row of every dataset interns or looks up its measure codename, and
+    parallel imports do so from several threads, so a single lock around the
+    index would serialise them. As strings are never removed, a pointer found
+    once stays valid, and each thread copies the entries it finds in to a
+    thread_local cache that it checks without locking.
+ */
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "symbols.h"
+
+namespace {
+
+using SymbolIndex = std::unordered_multimap<std::size_t, const std::string*>;
+
+struct SymbolTable {
+	std::mutex mutex;
+	std::deque<std::string> strings;
+	SymbolIndex index;
+	const std::string* emptyString;
+
+	SymbolTable() : mutex(), strings(1), index(), emptyString(&strings.front()) {
+		index.insert(std::make_pair(hash("", 0, false), emptyString));
+	}
+
+	/*
+		Convert an ASCII letter to lowercase, as BethYw::toLowercase() does.
+	*/
+	static char lower(const char c) noexcept {
+		return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c;
+	}
+
+	/*
+		FNV-1a hash of the characters, or of the characters converted to
+		lowercase, so a lowercase string can be looked up without building it.
+	*/
+	static std::size_t hash(const char* data, std::size_t size, const bool lowercase) noexcept {
+		std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+		for (std::size_t i = 0; i < size; i++) {
+			char c = lowercase ? lower(data[i]) : data[i];
+			h = (h ^ static_cast<unsigned char>(c)) * static_cast<std::size_t>(1099511628211ULL);
+		}
+		return h;
+	}
+
+	/*
+		The entries of index that this thread has already found.
+	*/
+	static SymbolIndex& cache() {
+		thread_local SymbolIndex entries;
+		return entries;
+	}
+
+	/*
+		Find an interned string in entries, which is either index (the mutex
+		must be held) or this thread's cache.
+	*/
+	static const std::string* find(const SymbolIndex& entries,
+		const char* data,
+		std::size_t size,
+		std::size_t h,
+		const bool lowercase) noexcept {
+		auto range = entries.equal_range(h);
+		for (auto it = range.first; it != range.second; it++) {
+			const std::string* candidate = it->second;
+			if (candidate->size() != size) {
+				continue;
+			}
+			if (!lowercase) {
+				if (std::memcmp(candidate->data(), data, size) == 0) {
+					return candidate;
+				}
+				continue;
+			}
+			std::size_t i = 0;
+			while (i < size && (*candidate)[i] == lower(data[i])) {
+				i++;
+			}
+			if (i == size) {
+				return candidate;
+			}
+		}
+		return nullptr;
+	}
+
+	/*
+		Find or add an interned string.
+	*/
+	const std::string* intern(const char* data, std::size_t size, const bool lowercase) {
+		std::size_t h = hash(data, size, lowercase);
+		const std::string* found = find(cache(), data, size, h, lowercase);
+		if (found != nullptr) {
+			return found;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			found = find(index, data, size, h, lowercase);
+			if (found == nullptr) {
+				strings.emplace_back(data, size);
+				if (lowercase) {
+					for (auto it = strings.back().begin(); it != strings.back().end(); it++) {
+						*it = lower(*it);
+					}
+				}
+				found = &strings.back();
+				index.insert(std::make_pair(h, found));
+			}
+		}
+		cache().insert(std::make_pair(h, found));
+		return found;
+	}
+
+	/*
+		Find an interned string without adding it.
+	*/
+	const std::string* lookup(const char* data, std::size_t size, const bool lowercase) {
+		std::size_t h = hash(data, size, lowercase);
+		const std::string* found = find(cache(), data, size, h, lowercase);
+		if (found != nullptr) {
+			return found;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			found = find(index, data, size, h, lowercase);
+		}
+		if (found != nullptr) {
+			cache().insert(std::make_pair(h, found));
+		}
+		return found;
+	}
+};
+
+SymbolTable& table() {
+	static SymbolTable symbols;
+	return symbols;
+}
+
+} // namespace
+
+/*
+    BethYw::Symbol::Symbol()
+
+    Construct the Symbol for the empty string.
+*/
+BethYw::Symbol::Symbol() noexcept : value(table().emptyString) {
+}
+
+BethYw::Symbol::Symbol(const std::string* value) noexcept : value(value) {
+}
+
+/*
+	str()
+	Returns the interned string.
+*/
+const std::string& BethYw::Symbol::str() const noexcept {
+	return *value;
+}
+
+/*
+	empty()
+	Returns true if this is the Symbol for the empty string.
+*/
+const bool BethYw::Symbol::empty() const noexcept {
+	return value->empty();
+}
+
+bool BethYw::operator==(const Symbol lhs, const Symbol rhs) noexcept {
+	return lhs.value == rhs.value;
+}
+
+bool BethYw::operator!=(const Symbol lhs, const Symbol rhs) noexcept {
+	return lhs.value != rhs.value;
+}
+
+/*
+    BethYw::intern(data, size)
+
+    Get the Symbol for a string, adding the string to the table if it is not
+    already there. This is safe to call from several threads at once, and
+    only locks the table the first time a thread sees the string.
+
+    @param data
+        The characters of the string
+
+    @param size
+        The number of characters
+
+    @return
+        The Symbol for the string
+
+    @example
+        BethYw::Symbol code = BethYw::intern(field.data, field.size);
+*/
+BethYw::Symbol BethYw::intern(const char* data, std::size_t size) {
+	return Symbol(table().intern(data, size, false));
+}
+
+/*
+    BethYw::intern(str)
+
+    As above, for a std::string.
+*/
+BethYw::Symbol BethYw::intern(const std::string& str) {
+	return intern(str.data(), str.size());
+}
+
+/*
+    BethYw::findSymbol(data, size, symbol)
+
+    Get the Symbol for a string if it has already been interned, without
+    adding it to the table. Lookups of strings that may not exist (e.g. a
+    user's search) use this so they do not fill the table.
+
+    @param data
+        The characters of the string
+
+    @param size
+        The number of characters
+
+    @param symbol
+        Set to the Symbol if the string has been interned
+
+    @return
+        true if the string has been interned
+*/
+const bool BethYw::findSymbol(const char* data, std::size_t size, Symbol& symbol) {
+	const std::string* found = table().lookup(data, size, false);
+	if (found == nullptr) {
+		return false;
+	}
+	symbol = Symbol(found);
+	return true;
+}
+
+/*
+    BethYw::findSymbol(str, symbol)
+
+    As above, for a std::string.
+*/
+const bool BethYw::findSymbol(const std::string& str, Symbol& symbol) {
+	return findSymbol(str.data(), str.size(), symbol);
+}
+
+/*
+    BethYw::internLowercase(data, size)
+
+    Get the Symbol for a string converted to lowercase (ASCII letters only,
+    as BethYw::toLowercase()), adding it to the table if it is not already
+    there. The lowercase string is only built if it is added, so looking up
+    e.g. "POP" when "pop" has been interned does not allocate.
+
+    @param data
+        The characters of the string
+
+    @param size
+        The number of characters
+
+    @return
+        The Symbol for the lowercase string
+
+    @example
+        BethYw::Symbol codename = BethYw::internLowercase("Pop", 3); // "pop"
+*/
+BethYw::Symbol BethYw::internLowercase(const char* data, std::size_t size) {
+	return Symbol(table().intern(data, size, true));
+}
+
+/*
+    BethYw::internLowercase(str)
+
+    As above, for a std::string.
+*/
+BethYw::Symbol BethYw::internLowercase(const std::string& str) {
+	return internLowercase(str.data(), str.size());
+}
+
+/*
+    BethYw::findLowercaseSymbol(data, size, symbol)
+
+    Get the Symbol for a string converted to lowercase if it has already been
+    interned, without adding it to the table or building the lowercase
+    string. This is the case insensitive lookup used for measure codenames.
+
+    @param data
+        The characters of the string
+
+    @param size
+        The number of characters
+
+    @param symbol
+        Set to the Symbol if the lowercase string has been interned
+
+    @return
+        true if the lowercase string has been interned
+*/
+const bool BethYw::findLowercaseSymbol(const char* data, std::size_t size, Symbol& symbol) {
+	const std::string* found = table().lookup(data, size, true);
+	if (found == nullptr) {
+		return false;
+	}
+	symbol = Symbol(found);
+	return true;
+}
+
+/*
+    BethYw::findLowercaseSymbol(str, symbol)
+
+    As above, for a std::string.
+*/
+const bool BethYw::findLowercaseSymbol(const std::string& str, Symbol& symbol) {
+	return findLowercaseSymbol(str.data(), str.size(), symbol);
+}
@@ -0,0 +1,107 @@
+#ifndef SYMBOLS_H_
+#define SYMBOLS_H_
+
+/*
+    +---------------------------------------+
+    | BETH YW? WELSH GOVERNMENT DATA PARSER |
+    +---------------------------------------+
+
+    AUTHOR: 979248
+
+    This file contains the declaration of Symbol, an interned string.
+
+    The same few strings (authority codes, measure codes and labels, area
+    names) are repeated across every Area and Measure, and on every row of
+    every dataset. Interning them stores each distinct string once, in a
+    process-wide table, and every copy is then just a handle to it. Two
+    Symbols are the same string exactly when their handles are equal, so
+    comparing them for equality never looks at the characters.
+
+    The table is shared by every Areas instance, including those populated on
+    other threads (see Areas::merge()), so Symbols can be moved between them.
+    Interned strings live until the program exits. Each thread keeps its own
+    cache of the strings it has found, so only adding a string, or looking
+    one up for the first time on a thread, takes the table's lock.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace BethYw {
+
+class Symbol {
+public:
+	Symbol() noexcept;
+	const std::string& str() const noexcept;
+	const bool empty() const noexcept;
+
+	friend bool operator==(const Symbol lhs, const Symbol rhs) noexcept;
+	friend bool operator!=(const Symbol lhs, const Symbol rhs) noexcept;
+	friend Symbol intern(const char* data, std::size_t size);
+	friend const bool findSymbol(const char* data, std::size_t size, Symbol& symbol);
+	friend Symbol internLowercase(const char* data, std::size_t size);
+	friend const bool findLowercaseSymbol(const char* data, std::size_t size, Symbol& symbol);
+	friend struct SymbolHash;
+	friend struct SymbolHandleOrder;
+
+private:
+	explicit Symbol(const std::string* value) noexcept;
+	const std::string* value;
+};
+
+bool operator==(const Symbol lhs, const Symbol rhs) noexcept;
+
+bool operator!=(const Symbol lhs, const Symbol rhs) noexcept;
+
+Symbol intern(const char* data, std::size_t size);
+
+Symbol intern(const std::string& str);
+
+const bool findSymbol(const char* data, std::size_t size, Symbol& symbol);
+
+const bool findSymbol(const std::string& str, Symbol& symbol);
+
+Symbol internLowercase(const char* data, std::size_t size);
+
+Symbol internLowercase(const std::string& str);
+
+const bool findLowercaseSymbol(const char* data, std::size_t size, Symbol& symbol);
+
+const bool findLowercaseSymbol(const std::string& str, Symbol& symbol);
+
+/*
+    Orders Symbols by their strings, for sorting Symbols that are output in
+    alphabetical order. Equal Symbols are spotted without comparing their
+    characters, but any others compare their characters.
+*/
+struct SymbolOrder {
+	bool operator()(const Symbol lhs, const Symbol rhs) const noexcept {
+		return lhs != rhs && lhs.str() < rhs.str();
+	}
+};
+
+/*
+    Orders Symbols by their handles, for ordered containers that are looked
+    up far more often than they are output. This only compares pointers, but
+    the order is not alphabetical, so the contents must be sorted (e.g. with
+    SymbolOrder) before being output.
+*/
+struct SymbolHandleOrder {
+	bool operator()(const Symbol lhs, const Symbol rhs) const noexcept {
+		return std::less<const std::string*>()(lhs.value, rhs.value);
+	}
+};
+
+/*
+    Hashes the handle of a Symbol, for unordered containers.
+*/
+struct SymbolHash {
+	std::size_t operator()(const Symbol symbol) const noexcept {
+		return std::hash<const std::string*>()(symbol.value);
+	}
+};
+
+} // namespace BethYw
+
+#endif // SYMBOLS_H_
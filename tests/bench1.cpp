@@ -0,0 +1,152 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Benchmark for the structural scanning kernels. Build and run with:
+
+    ./build.sh bench1 && ./bin/bethyw-bench
+
+  Each kernel is timed on synthetic data shaped like the by-year CSV files
+  and the StatsWales JSON files, and the throughput is printed in MB/s. The
+  JSON is both split in to chunks of rows (as for a parallel parse) and
+  parsed row by row from a stream on a single thread.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../csv.h"
+#include "../datasets.h"
+#include "../scan.h"
+#include "../statswales.h"
+
+namespace {
+
+const char* kernelName(const BethYw::ScanKernel kernel) {
+  switch (kernel) {
+    case BethYw::AVX2Scan:
+      return "AVX2";
+    case BethYw::SSE42Scan:
+      return "SSE4.2";
+    default:
+      return "scalar";
+  }
+}
+
+/*
+  Run fn repeatedly and return the best throughput in MB/s.
+*/
+template <typename Fn>
+double throughput(const std::size_t bytes, Fn fn) {
+  double best = 0;
+  for (int run = 0; run < 5; run++) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double mbs = bytes / elapsed.count() / (1024 * 1024);
+    if (mbs > best) {
+      best = mbs;
+    }
+  }
+  return best;
+}
+
+std::string byYearCSV(const unsigned int rows) {
+  std::string csv = "AuthorityCode";
+  for (unsigned int year = 1991; year <= 2019; year++) {
+    csv += "," + std::to_string(year);
+  }
+  csv += "\n";
+  for (unsigned int i = 0; i < rows; i++) {
+    csv += "W0600" + std::to_string(1000 + i % 1000);
+    for (unsigned int year = 1991; year <= 2019; year++) {
+      csv += "," + std::to_string((i * 7919 + year * 104729) % 1000000 / 100.0);
+    }
+    csv += "\n";
+  }
+  return csv;
+}
+
+std::string welshStatsJSON(const unsigned int rows) {
+  std::string json = "{\"odata.metadata\":\"http://example\",\"value\":[";
+  for (unsigned int i = 0; i < rows; i++) {
+    json += std::string(i ? "," : "") +
+      "{\"Data\":" + std::to_string(i % 9973) + ".5,\"Localauthority_Code\":\"W0600" +
+      std::to_string(1000 + i % 1000) + "\",\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\","
+      "\"Localauthority_SortOrder\":\"401\",\"Measure_Code\":\"Dens\","
+      "\"Measure_ItemName_ENG\":\"Population density (people per square kilometre)\","
+      "\"Year_Code\":\"" + std::to_string(1991 + i % 29) + "\"}";
+  }
+  json += "]}";
+  return json;
+}
+
+} // namespace
+
+int main() {
+  const std::string csv = byYearCSV(200000);
+  const std::string json = welshStatsJSON(200000);
+  const BethYw::ScanKernel kernels[] = {BethYw::ScalarScan, BethYw::SSE42Scan, BethYw::AVX2Scan};
+  const BethYw::ByteSet delimiters(",\n\"");
+
+  std::printf("CSV: %zu bytes, JSON: %zu bytes\n\n", csv.size(), json.size());
+  std::printf("%-8s %14s %14s %14s %14s\n", "kernel", "scan MB/s", "CSV MB/s", "split MB/s", "rows MB/s");
+
+  for (auto kernel : kernels) {
+    if (!BethYw::setScanKernel(kernel)) {
+      std::printf("%-8s %14s\n", kernelName(kernel), "unsupported");
+      continue;
+    }
+
+    std::size_t found = 0;
+    double scan = throughput(csv.size(), [&]() {
+      const char* end = csv.data() + csv.size();
+      for (const char* p = csv.data(); p < end; p++) {
+        p = BethYw::findFirstOf(p, end, delimiters);
+        found++;
+      }
+    });
+
+    std::size_t fields = 0;
+    double reader = throughput(csv.size(), [&]() {
+      std::istringstream stream(csv);
+      CsvReader csvReader(stream);
+      while (csvReader.readRecord()) {
+        fields += csvReader.fields().size();
+      }
+    });
+
+    std::size_t chunks = 0;
+    double splitter = throughput(json.size(), [&]() {
+      std::vector<WelshStatsChunk> split;
+      bool hasData;
+      splitWelshStatsRows(json.data(), json.size(), 4, split, hasData);
+      chunks += split.size();
+    });
+
+    std::size_t rows = 0;
+    double parser = throughput(json.size(), [&]() {
+      std::istringstream stream(json);
+      WelshStatsHandler handler(BethYw::InputFiles::POPDEN.COLS, [&rows](const WelshStatsRow&) {
+        rows++;
+      });
+      handler.parse(stream);
+    });
+
+    std::printf("%-8s %14.0f %14.0f %14.0f %14.0f\n", kernelName(kernel), scan, reader, splitter, parser);
+    if (found == 0 || fields == 0 || chunks == 0 || rows == 0) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
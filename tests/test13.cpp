@@ -0,0 +1,227 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../statswales.h"
+
+SCENARIO( "a StatsWales JSON stream can be read one row at a time", "[WelshStatsHandler][stream]" ) {
+
+  const auto &cols = BethYw::InputFiles::DATASETS[0].COLS;
+
+  GIVEN( "a StatsWales document with two rows and unmapped keys" ) {
+
+    std::istringstream stream(
+      "{\"odata.metadata\":\"x\",\"value\":["
+      "{\"Data\":95.5,\"Localauthority_Code\":\"W06000001\",\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\","
+      "\"Localauthority_SortOrder\":\"401\",\"Measure_Code\":\"Dens\",\"Measure_ItemName_ENG\":\"Population density\","
+      "\"Year_Code\":\"1997\",\"Nested\":{\"Year_Code\":\"1\"}},"
+      "{\"Data\":\"68592\",\"Localauthority_Code\":\"W06000002\",\"Localauthority_ItemName_ENG\":\"Gwynedd\","
+      "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"1996\"}"
+      "],\"odata.nextLink\":\"y\"}");
+
+    std::vector<WelshStatsRow> rows;
+    WelshStatsHandler handler(cols, [&](const WelshStatsRow &row) { rows.push_back(row); });
+
+    THEN( "the stream is parsed and every row is handed on in order" ) {
+
+      REQUIRE( nlohmann::json::sax_parse(stream, &handler) );
+      REQUIRE( handler.hasData() );
+      REQUIRE( rows.size() == 2 );
+
+      REQUIRE( rows[0].authCode == "W06000001" );
+      REQUIRE( rows[0].authName == "Isle of Anglesey" );
+      REQUIRE( rows[0].measureCode == "Dens" );
+      REQUIRE( rows[0].measureName == "Population density" );
+      REQUIRE( rows[0].year == 1997 );
+      REQUIRE( rows[0].value == 95.5 );
+
+      REQUIRE( rows[1].authCode == "W06000002" );
+      REQUIRE( rows[1].year == 1996 );
+      REQUIRE( rows[1].value == 68592 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a StatsWales document with a row missing a mapped key" ) {
+
+    std::istringstream stream(
+      "{\"value\":[{\"Data\":1.0,\"Localauthority_Code\":\"W06000001\",\"Year_Code\":\"1997\"}]}");
+
+    Areas areas;
+
+    THEN( "a std::runtime_error is thrown when populating an Areas instance" ) {
+
+      REQUIRE_THROWS_AS( areas.populateFromWelshStatsJSON(stream, cols), std::runtime_error );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an empty StatsWales document" ) {
+
+    std::istringstream stream("{}");
+    Areas areas;
+
+    const std::string exceptionMessage = "Areas::populateFromWelshStatsJSON: File has no data";
+
+    THEN( "a std::runtime_error is thrown with the message '" + exceptionMessage + "'" ) {
+
+      REQUIRE_THROWS_WITH( areas.populateFromWelshStatsJSON(stream, cols), exceptionMessage );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "the rows of a StatsWales document can be split in to chunks", "[WelshStatsHandler][chunks]" ) {
+
+  const auto &cols = BethYw::InputFiles::DATASETS[0].COLS;
+
+  GIVEN( "a StatsWales document with ten rows, including brackets and commas in strings" ) {
+
+    std::string document = "{\"odata.metadata\":\"[,]\",\"value\":[";
+    for (int i = 0; i < 10; i++) {
+      document += std::string(i ? "," : "") +
+        "{\"Data\":" + std::to_string(i) + ",\"Localauthority_Code\":\"W0600000" + std::to_string(i) + "\"," +
+        "\"Localauthority_ItemName_ENG\":\"A \\\"[quoted]\\\", {name}\",\"Measure_Code\":\"Pop\"," +
+        "\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"199" + std::to_string(i) + "\"}";
+    }
+    document += "],\"odata.nextLink\":\"]\"}";
+
+    std::vector<WelshStatsChunk> chunks;
+    bool hasData = false;
+
+    WHEN( "the document is split in to four chunks" ) {
+
+      REQUIRE( splitWelshStatsRows(document.data(), document.size(), 4, chunks, hasData) );
+
+      THEN( "there are four chunks and parsing them in order gives every row in order" ) {
+
+        REQUIRE( hasData );
+        REQUIRE( chunks.size() == 4 );
+
+        std::vector<unsigned int> years;
+        WelshStatsHandler handler(cols, [&](const WelshStatsRow &row) { years.push_back(row.year); });
+        for (auto &chunk : chunks) {
+          REQUIRE( handler.parseRows(document.data() + chunk.first, chunk.second - chunk.first) );
+        }
+
+        REQUIRE( years.size() == 10 );
+        for (unsigned int i = 0; i < 10; i++) {
+          REQUIRE( years[i] == 1990 + i );
+        }
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "the document is split in to more chunks than it has rows" ) {
+
+      REQUIRE( splitWelshStatsRows(document.data(), document.size(), 50, chunks, hasData) );
+
+      THEN( "every chunk has exactly one row" ) {
+
+        REQUIRE( chunks.size() == 10 );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "the document is truncated" ) {
+
+      THEN( "the document is reported as malformed" ) {
+
+        REQUIRE_FALSE( splitWelshStatsRows(document.data(), document.size() - 1, 4, chunks, hasData) );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+  GIVEN( "large StatsWales documents that are only malformed outside the \"value\" array" ) {
+
+    std::string rows;
+    for (int i = 0; i < 6500; i++) {
+      rows += std::string(i ? "," : "") +
+        "{\"Data\":" + std::to_string(i) + ",\"Localauthority_Code\":\"W06000001\"," +
+        "\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\",\"Measure_Code\":\"Pop\"," +
+        "\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"" + std::to_string(1000 + i) + "\"}";
+    }
+    const std::vector<std::string> documents = {
+      "{\"odata.metadata\":\"x\" \"y\",\"value\":[" + rows + "]}",
+      "{\"odata.metadata\":tru,\"value\":[" + rows + "]}",
+      "{\"value\":[" + rows + "],\"odata.nextLink\":nul}",
+      "{\"value\":[" + rows + "],\"odata.nextLink\":\"y\",}"
+    };
+
+    THEN( "they are rejected on one thread and on four threads" ) {
+
+      for (const auto &document : documents) {
+        REQUIRE( document.size() > 4 * 256 * 1024 );
+        for (unsigned int threads : {1, 4}) {
+          Areas areas;
+          areas.setParseThreads(threads);
+          std::istringstream stream(document);
+          REQUIRE_THROWS_WITH( areas.populateFromWelshStatsJSON(stream, cols),
+            "Areas::populateFromWelshStatsJSON: File is malformed" );
+        }
+      }
+
+    } // THEN
+
+    THEN( "the same rows with valid metadata are accepted on four threads" ) {
+
+      Areas areas;
+      areas.setParseThreads(4);
+      std::istringstream stream("{\"odata.metadata\":\"x\",\"value\":[" + rows + "],\"odata.nextLink\":\"y\"}");
+      areas.populateFromWelshStatsJSON(stream, cols);
+      REQUIRE( areas.getArea("W06000001").getMeasure("pop").size() == 6500 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "popu1009.json parsed on one thread and on four threads" ) {
+
+    Areas areas;
+    Areas areasThreaded;
+    areasThreaded.setParseThreads(4);
+
+    std::ifstream stream("datasets/popu1009.json");
+    std::ifstream streamThreaded("datasets/popu1009.json");
+
+    areas.populateFromWelshStatsJSON(stream, cols);
+    areasThreaded.populateFromWelshStatsJSON(streamThreaded, cols);
+
+    THEN( "the same data is imported" ) {
+
+      REQUIRE( areas.size() == areasThreaded.size() );
+      REQUIRE( areas.toJSON() == areasThreaded.toJSON() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
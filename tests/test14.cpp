@@ -0,0 +1,100 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../input.h"
+
+SCENARIO( "a source file can be mapped in to memory and read", "[InputMappedFile][existent]" ) {
+
+  const std::string test_file = "datasets/areas.csv";
+
+  auto file_contents = [](const std::string &path) {
+    std::ifstream file(path, std::ifstream::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  };
+
+  GIVEN( "a constructed InputMappedFile instance" ) {
+
+    InputMappedFile input(test_file);
+
+    THEN( "the source value can be retrieved" ) {
+
+      REQUIRE( input.getSource() == test_file );
+
+    } // THEN
+
+    THEN( "the file can be opened without exception" ) {
+
+      REQUIRE_NOTHROW( input.open() );
+
+      AND_THEN( "the mapped bytes are the same as the file contents" ) {
+
+        input.open();
+        REQUIRE( std::string(input.data(), input.size()) == file_contents(test_file) );
+
+      } // AND_THEN
+
+      AND_THEN( "the stream reads the file contents and can seek" ) {
+
+        std::istream &stream = input.open();
+        std::string line;
+        std::getline(stream, line);
+        REQUIRE( line == "Local authority code,Name (eng),Name (cym)" );
+
+        REQUIRE_NOTHROW( stream.seekg(1, stream.beg) );
+        REQUIRE( stream.tellg() == 1 );
+        REQUIRE( stream.get() == 'o' );
+
+      } // AND_THEN
+
+      AND_THEN( "an Areas instance can be populated from the stream" ) {
+
+        Areas areas;
+        REQUIRE_NOTHROW( areas.populateFromAuthorityCodeCSV(input.open(), BethYw::InputFiles::AREAS.COLS) );
+        REQUIRE( areas.size() == 22 );
+
+      } // AND_THEN
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a nonexistant source file cannot be mapped for reading", "[InputMappedFile][nonexistent]" ) {
+
+  const std::string test_file = "datasets/jibberish.json";
+
+  GIVEN( "a constructed InputMappedFile instance" ) {
+
+    InputMappedFile input(test_file);
+
+    const std::string exceptionMessage = "InputMappedFile::open: Failed to open file " + test_file;
+
+    THEN( "a std::runtime_error is thrown with message " + exceptionMessage ) {
+
+      REQUIRE_THROWS_AS( input.open(), std::runtime_error );
+      REQUIRE_THROWS_WITH( input.open(), exceptionMessage );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
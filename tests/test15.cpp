@@ -0,0 +1,119 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../areas.h"
+#include "../csv.h"
+#include "../datasets.h"
+
+SCENARIO( "a CSV stream can be split in to records and fields", "[CsvReader][fields]" ) {
+
+  auto read_all = [](const std::string &text, std::size_t chunkSize) {
+    std::istringstream stream(text);
+    CsvReader reader(stream, chunkSize);
+    std::vector<std::vector<std::string>> records;
+    while (reader.readRecord()) {
+      std::vector<std::string> record;
+      for (auto &field : reader.fields()) {
+        record.push_back(field.str());
+      }
+      records.push_back(record);
+    }
+    return records;
+  };
+
+  GIVEN( "a CSV stream with quoted fields, CRLF line endings and a blank line" ) {
+
+    const std::string text =
+      "AuthorityCode,1991,2001\r\n"
+      "W06000001,\"Isle of \"\"Anglesey\"\", Ynys\nMon\",2\r\n"
+      "\r\n"
+      "W06000002,,3";
+
+    const std::vector<std::vector<std::string>> expected = {
+      {"AuthorityCode", "1991", "2001"},
+      {"W06000001", "Isle of \"Anglesey\", Ynys\nMon", "2"},
+      {"W06000002", "", "3"}
+    };
+
+    THEN( "the records and fields are read correctly" ) {
+
+      REQUIRE( read_all(text, 64 * 1024) == expected );
+
+    } // THEN
+
+    THEN( "the records and fields are read correctly when records span many reads" ) {
+
+      REQUIRE( read_all(text, 1) == expected );
+      REQUIRE( read_all(text, 3) == expected );
+      REQUIRE( read_all(text, 7) == expected );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a CSV stream whose records end with a delimiter" ) {
+
+    const std::string text =
+      "AuthorityCode,1991,\r\n"
+      "W06000001,\"1\",\n"
+      "W06000002,,\n"
+      ",\n"
+      "W06000003,,3";
+
+    const std::vector<std::vector<std::string>> expected = {
+      {"AuthorityCode", "1991"},
+      {"W06000001", "1"},
+      {"W06000002", ""},
+      {""},
+      {"W06000003", "", "3"}
+    };
+
+    THEN( "the trailing delimiter does not add an empty field" ) {
+
+      REQUIRE( read_all(text, 64 * 1024) == expected );
+      REQUIRE( read_all(text, 1) == expected );
+
+    } // THEN
+
+    THEN( "an areas.csv file with trailing delimiters is imported" ) {
+
+      std::istringstream stream(
+        "Local authority code,Name (eng),Name (cym),\n"
+        "W06000001,Isle of Anglesey,Ynys Mon,\n");
+      Areas areas;
+      areas.populateFromAuthorityCodeCSV(stream, BethYw::InputFiles::AREAS.COLS);
+      REQUIRE( areas.size() == 1 );
+      REQUIRE( areas.getArea("W06000001").getName("cym") == "Ynys Mon" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an empty CSV stream" ) {
+
+    THEN( "no records are read" ) {
+
+      REQUIRE( read_all("", 16).empty() );
+      REQUIRE( read_all("\n\r\n", 16).empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
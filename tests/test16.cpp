@@ -0,0 +1,101 @@
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+#include "../areas.h"
+#include "../area.h"
+#include "../measure.h"
+
+SCENARIO( "Areas instances parsed separately can be merged", "[Areas][merge]" ) {
+
+  GIVEN( "two Areas instances with data for the same Area" ) {
+
+    Areas areas;
+    Areas partial;
+
+    Area area1("W06000011");
+    area1.setName("eng", "Swansea");
+    Measure measure1("pop", "Population");
+    measure1.setValue(1990, 1);
+    measure1.setValue(1991, 2);
+    area1.setMeasure("pop", measure1);
+    areas.setArea("W06000011", area1);
+
+    Area area2("W06000011");
+    area2.setName("cym", "Abertawe");
+    Measure measure2("pop", "Population");
+    measure2.setValue(1991, 3);
+    area2.setMeasure("pop", measure2);
+    partial.setArea("W06000011", area2);
+    partial.setArea("W06000001", Area("W06000001"));
+
+    WHEN( "the second instance is merged in to the first" ) {
+
+      areas.merge(partial);
+
+      THEN( "the data is combined, with the merged instance taking precedence" ) {
+
+        REQUIRE( areas.size() == 2 );
+        REQUIRE( areas.getArea("W06000011").getName("eng") == "Swansea" );
+        REQUIRE( areas.getArea("W06000011").getName("cym") == "Abertawe" );
+        REQUIRE( areas.getArea("W06000011").getMeasure("pop").getValue(1990) == 1 );
+        REQUIRE( areas.getArea("W06000011").getMeasure("pop").getValue(1991) == 3 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+  GIVEN( "an Areas instance with a reference instance containing an Area" ) {
+
+    Areas reference;
+    reference.setArea("W06000011", Area("W06000011"));
+
+    Areas partial;
+    partial.setReference(&reference);
+
+    std::unordered_set<std::string> areasFilter = {"swansea"};
+
+    WHEN( "a file with the Area's code but no matching names is parsed" ) {
+
+      std::istringstream stream(
+        "AuthorityCode,1991\n"
+        "W06000011,5\n"
+        "W06000001,6\n");
+
+      BethYw::SourceColumnMapping cols = {
+        {BethYw::AUTH_CODE,           "AuthorityCode"},
+        {BethYw::SINGLE_MEASURE_CODE, "Pop"},
+        {BethYw::SINGLE_MEASURE_NAME, "Population"}
+      };
+
+      partial.populateFromAuthorityByYearCSV(stream, cols, &areasFilter);
+
+      THEN( "the Area in the reference instance passes the areas filter" ) {
+
+        REQUIRE( partial.size() == 1 );
+        REQUIRE( partial.getArea("W06000011").getMeasure("pop").getValue(1991) == 5 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
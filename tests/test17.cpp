@@ -0,0 +1,166 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../csv.h"
+#include "../scan.h"
+
+SCENARIO( "every scanning kernel finds the same bytes", "[scan][kernels]" ) {
+
+  GIVEN( "a block of random text with a few delimiters" ) {
+
+    std::mt19937 random(1009);
+    std::string text(300, 'a');
+    for (auto &c : text) {
+      unsigned int r = random() % 40;
+      c = r == 0 ? ',' : r == 1 ? '\n' : r == 2 ? '"' : static_cast<char>('a' + r % 26);
+    }
+    text[150] = static_cast<char>(0xE2);
+
+    const BethYw::ByteSet delimiters(",\n\"");
+    const BethYw::ScanKernel kernels[] = {BethYw::SSE42Scan, BethYw::AVX2Scan};
+
+    THEN( "each supported kernel agrees with the scalar kernel at every offset and length" ) {
+
+      const char *data = text.data();
+      for (auto kernel : kernels) {
+        if (!BethYw::isScanKernelSupported(kernel)) {
+          continue;
+        }
+        for (std::size_t from = 0; from < 70; from++) {
+          for (std::size_t to = from; to <= text.size(); to++) {
+            const char *expected = BethYw::findFirstOf(data + from, data + to, delimiters, BethYw::ScalarScan);
+            const char *actual = BethYw::findFirstOf(data + from, data + to, delimiters, kernel);
+            REQUIRE( actual == expected );
+          }
+        }
+      }
+
+    } // THEN
+
+    THEN( "each supported kernel finds the same matches in every 64 byte block" ) {
+
+      for (auto kernel : kernels) {
+        if (!BethYw::isScanKernelSupported(kernel)) {
+          continue;
+        }
+        for (std::size_t from = 0; from + BethYw::BLOCK_SIZE <= text.size(); from++) {
+          const char *block = text.data() + from;
+          REQUIRE( BethYw::matchBlock(block, delimiters, kernel) ==
+                   BethYw::matchBlock(block, delimiters, BethYw::ScalarScan) );
+        }
+      }
+
+    } // THEN
+
+    THEN( "the scalar block mask has a bit for every delimiter" ) {
+
+      std::uint64_t mask = BethYw::matchBlock(text.data(), delimiters, BethYw::ScalarScan);
+      for (std::size_t i = 0; i < BethYw::BLOCK_SIZE; i++) {
+        bool expected = text[i] == ',' || text[i] == '\n' || text[i] == '"';
+        REQUIRE( ((mask >> i) & 1) == (expected ? 1u : 0u) );
+      }
+      while (mask != 0) {
+        std::size_t i = BethYw::nextMatch(mask);
+        REQUIRE( delimiters.contains(text[i]) );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a block with no delimiters at all" ) {
+
+    const std::string text(200, 'x');
+    const BethYw::ByteSet delimiters(",");
+
+    THEN( "every kernel returns the end of the block" ) {
+
+      const char *end = text.data() + text.size();
+      REQUIRE( BethYw::findFirstOf(text.data(), end, delimiters, BethYw::ScalarScan) == end );
+      REQUIRE( BethYw::findFirstOf(text.data(), end, delimiters, BethYw::SSE42Scan) == end );
+      REQUIRE( BethYw::findFirstOf(text.data(), end, delimiters, BethYw::AVX2Scan) == end );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an empty set or one with more than eight bytes" ) {
+
+    THEN( "a std::invalid_argument is thrown" ) {
+
+      REQUIRE_THROWS_AS( BethYw::ByteSet(""), std::invalid_argument );
+      REQUIRE_THROWS_AS( BethYw::ByteSet("123456789"), std::invalid_argument );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a CSV file is read the same with every scanning kernel", "[scan][CsvReader]" ) {
+
+  GIVEN( "a CSV file with quoted fields spanning lines" ) {
+
+    std::string document;
+    for (int i = 0; i < 50; i++) {
+      document += "W0600000" + std::to_string(i % 10) +
+        ",\"Name, with \"\"quotes\"\"\nand a line break\"," + std::to_string(i) + "\r\n";
+    }
+
+    const BethYw::ScanKernel original = BethYw::scanKernel();
+
+    THEN( "the records are identical to those found by the scalar kernel" ) {
+
+      std::vector<std::vector<std::string>> expected;
+      REQUIRE( BethYw::setScanKernel(BethYw::ScalarScan) );
+      std::istringstream scalarStream(document);
+      CsvReader scalarReader(scalarStream, 7);
+      while (scalarReader.readRecord()) {
+        std::vector<std::string> record;
+        for (auto &field : scalarReader.fields()) {
+          record.push_back(field.str());
+        }
+        expected.push_back(record);
+      }
+
+      REQUIRE( expected.size() == 50 );
+      REQUIRE( expected[0].size() == 3 );
+      REQUIRE( expected[0][1] == "Name, with \"quotes\"\nand a line break" );
+
+      REQUIRE( BethYw::setScanKernel(original) );
+      std::istringstream stream(document);
+      CsvReader reader(stream, 7);
+      for (auto &record : expected) {
+        REQUIRE( reader.readRecord() );
+        REQUIRE( reader.fields().size() == record.size() );
+        for (std::size_t i = 0; i < record.size(); i++) {
+          REQUIRE( reader.fields()[i] == record[i] );
+        }
+      }
+      REQUIRE_FALSE( reader.readRecord() );
+
+    } // THEN
+
+    BethYw::setScanKernel(original);
+
+  } // GIVEN
+
+} // SCENARIO
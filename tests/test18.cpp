@@ -0,0 +1,144 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../numbers.h"
+
+SCENARIO( "years and values can be decoded without exceptions", "[numbers]" ) {
+
+  GIVEN( "valid unsigned integers" ) {
+
+    THEN( "they are decoded to the same value as std::stoul" ) {
+
+      const std::vector<std::string> years = {"0", "1991", "2019", "0042", "4294967295"};
+      for (auto &year : years) {
+        unsigned int value = 0;
+        REQUIRE( BethYw::parseWholeNumber(year.data(), year.data() + year.size(), value) );
+        REQUIRE( value == std::stoul(year) );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "invalid unsigned integers" ) {
+
+    THEN( "they are reported as invalid or out of range and the value is unchanged" ) {
+
+      unsigned int value = 7;
+      std::string empty = "";
+      std::string letters = "abc";
+      std::string negative = "-1";
+      std::string tooLarge = "4294967296";
+      std::string trailing = "1991a";
+
+      REQUIRE( BethYw::parseNumber(empty.data(), empty.data(), value).error == BethYw::NumberInvalid );
+      REQUIRE( BethYw::parseNumber(letters.data(), letters.data() + 3, value).error == BethYw::NumberInvalid );
+      REQUIRE( BethYw::parseNumber(negative.data(), negative.data() + 2, value).error == BethYw::NumberInvalid );
+      REQUIRE( BethYw::parseNumber(tooLarge.data(), tooLarge.data() + 10, value).error == BethYw::NumberOutOfRange );
+      REQUIRE( value == 7 );
+
+      BethYw::NumberResult result = BethYw::parseNumber(trailing.data(), trailing.data() + 5, value);
+      REQUIRE( result.error == BethYw::NumberOk );
+      REQUIRE( result.ptr == trailing.data() + 4 );
+      REQUIRE( value == 1991 );
+      REQUIRE_FALSE( BethYw::parseWholeNumber(trailing.data(), trailing.data() + 5, value) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "valid decimal values, including ones too long for the fast path" ) {
+
+    THEN( "they are decoded to exactly the same double as std::strtod" ) {
+
+      const std::vector<std::string> values = {
+        "0", "-0", "1", "95.5", "68592", "711.6801", "-12.25", "+3.5", "0.1", ".5", "5.",
+        "97.126504", "1e3", "2.5E-3", "1e22", "1e23", "123456789012345678", "9007199254740993",
+        "10.0132764970959904", "0.000000000000000000000000001", "1.7976931348623157e308",
+        "3.14159265358979323846264338327950288", "4.9e-324"
+      };
+      for (auto &text : values) {
+        double value = 0;
+        REQUIRE( BethYw::parseWholeNumber(text.data(), text.data() + text.size(), value) );
+        double expected = std::strtod(text.c_str(), nullptr);
+        REQUIRE( std::memcmp(&value, &expected, sizeof(double)) == 0 );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "invalid decimal values" ) {
+
+    THEN( "they are not decoded as a whole" ) {
+
+      const std::vector<std::string> values = {"", "-", ".", "abc", "inf", "nan", "0x10", "1.5.2", "1e", "1,5", " 1"};
+      for (auto &text : values) {
+        double value = 0;
+        REQUIRE_FALSE( BethYw::parseWholeNumber(text.data(), text.data() + text.size(), value) );
+      }
+
+      std::string huge = "1e400";
+      double value = 0;
+      REQUIRE( BethYw::parseNumber(huge.data(), huge.data() + huge.size(), value).error == BethYw::NumberOutOfRange );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a by-year CSV file with an invalid value is reported as malformed", "[numbers][Areas]" ) {
+
+  const auto &cols = BethYw::InputFiles::DATASETS[5].COLS;
+
+  GIVEN( "a by-year CSV file with a value that is not a number" ) {
+
+    std::istringstream stream("AuthorityCode,1991,2001\nW06000001,1.5,abc\n");
+    Areas areas;
+
+    const std::string exceptionMessage = "Areas::populateFromAuthorityByYearCSV: Malformed file";
+
+    THEN( "a std::runtime_error is thrown with the message '" + exceptionMessage + "'" ) {
+
+      REQUIRE_THROWS_WITH( areas.populateFromAuthorityByYearCSV(stream, cols), exceptionMessage );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a by-year CSV file with a year that is not a number" ) {
+
+    std::istringstream stream("AuthorityCode,1991,Total\nW06000001,1.5,2.5\n");
+    Areas areas;
+
+    THEN( "a std::runtime_error is thrown" ) {
+
+      REQUIRE_THROWS_AS( areas.populateFromAuthorityByYearCSV(stream, cols), std::runtime_error );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
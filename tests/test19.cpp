@@ -0,0 +1,334 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <zlib.h>
+
+#ifdef BETHYW_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../input.h"
+
+namespace {
+
+std::string fileContents(const std::string &path) {
+  std::ifstream file(path, std::ifstream::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &path, const std::string &contents) {
+  std::ofstream file(path, std::ofstream::binary);
+  file.write(contents.data(), contents.size());
+}
+
+std::string gzipCompress(const std::string &contents) {
+  z_stream stream = {};
+  deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+  std::string compressed(deflateBound(&stream, contents.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(contents.data()));
+  stream.avail_in = static_cast<uInt>(contents.size());
+  stream.next_out = reinterpret_cast<Bytef *>(&compressed[0]);
+  stream.avail_out = static_cast<uInt>(compressed.size());
+  deflate(&stream, Z_FINISH);
+  compressed.resize(stream.total_out);
+  deflateEnd(&stream);
+  return compressed;
+}
+
+} // namespace
+
+SCENARIO( "a gzip compressed dataset can be read without decompressing it to disk", "[InputCompressedFile][gzip]" ) {
+
+  const auto &cols = BethYw::InputFiles::DATASETS[0].COLS;
+  const std::string plain = fileContents("datasets/popu1009.json");
+  const std::string compressedPath = "test19-popu1009.json.gz";
+  const std::string magicPath = "test19-popu1009.json";
+
+  Areas expected;
+  std::ifstream plainStream("datasets/popu1009.json");
+  expected.populateFromWelshStatsJSON(plainStream, cols);
+
+  GIVEN( "popu1009.json compressed with gzip" ) {
+
+    writeFile(compressedPath, gzipCompress(plain));
+
+    THEN( "the compression is detected from the extension" ) {
+
+      REQUIRE( detectCompression(compressedPath) == GzipCompression );
+
+    } // THEN
+
+    THEN( "the decompressed stream has the same contents as the original file" ) {
+
+      InputCompressedFile input(compressedPath, GzipCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == plain );
+
+    } // THEN
+
+    THEN( "the same data is imported as from the original file" ) {
+
+      Areas areas;
+      InputCompressedFile input(compressedPath, GzipCompression);
+      areas.populateFromWelshStatsJSON(input.open(), cols);
+      REQUIRE( areas.toJSON() == expected.toJSON() );
+
+    } // THEN
+
+    THEN( "createInputSource uses the compressed copy when there is no uncompressed file" ) {
+
+      auto input = BethYw::createInputSource(magicPath);
+      REQUIRE( input->getSource() == compressedPath );
+
+      Areas areas;
+      areas.populateFromWelshStatsJSON(input->open(), cols);
+      REQUIRE( areas.toJSON() == expected.toJSON() );
+
+    } // THEN
+
+    std::remove(compressedPath.c_str());
+
+  } // GIVEN
+
+  GIVEN( "a gzip compressed file without a .gz extension" ) {
+
+    writeFile(magicPath, gzipCompress(plain));
+
+    THEN( "the compression is detected from the magic bytes" ) {
+
+      REQUIRE( detectCompression(magicPath) == GzipCompression );
+      REQUIRE( detectCompression("datasets/popu1009.json") == NoCompression );
+
+      Areas areas;
+      auto input = BethYw::createInputSource(magicPath);
+      areas.populateFromWelshStatsJSON(input->open(), cols);
+      REQUIRE( areas.toJSON() == expected.toJSON() );
+
+    } // THEN
+
+    std::remove(magicPath.c_str());
+
+  } // GIVEN
+
+  GIVEN( "a file made of two gzip members one after the other" ) {
+
+    writeFile(compressedPath, gzipCompress(plain.substr(0, 1000)) + gzipCompress(plain.substr(1000)));
+
+    THEN( "the members are read as one stream" ) {
+
+      InputCompressedFile input(compressedPath, GzipCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == plain );
+
+    } // THEN
+
+    std::remove(compressedPath.c_str());
+
+  } // GIVEN
+
+  GIVEN( "gzip files whose members end exactly as a decompressed block fills" ) {
+
+    const std::string block(256 * 1024, 'a');
+
+    THEN( "a single member of one block is read to the end" ) {
+
+      writeFile(compressedPath, gzipCompress(block));
+      InputCompressedFile input(compressedPath, GzipCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == block );
+
+    } // THEN
+
+    THEN( "a single member of two blocks is read to the end" ) {
+
+      writeFile(compressedPath, gzipCompress(block + block));
+      InputCompressedFile input(compressedPath, GzipCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == block + block );
+
+    } // THEN
+
+    THEN( "a short member followed by a member of one block is read to the end" ) {
+
+      const std::string head(1000, 'b');
+      writeFile(compressedPath, gzipCompress(head) + gzipCompress(block));
+      InputCompressedFile input(compressedPath, GzipCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == head + block );
+
+    } // THEN
+
+    THEN( "a member ending on a block boundary is followed by the next member" ) {
+
+      const std::string head(1000, 'b');
+      writeFile(compressedPath, gzipCompress(head) + gzipCompress(block.substr(1000)) + gzipCompress(block));
+      InputCompressedFile input(compressedPath, GzipCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == head + block.substr(1000) + block );
+
+    } // THEN
+
+    std::remove(compressedPath.c_str());
+
+  } // GIVEN
+
+  GIVEN( "a truncated gzip file" ) {
+
+    std::string compressed = gzipCompress(plain);
+    writeFile(compressedPath, compressed.substr(0, compressed.size() / 2));
+
+    const std::string exceptionMessage = "InputCompressedFile: Corrupt or truncated data in " + compressedPath;
+
+    THEN( "a std::runtime_error is thrown with the message '" + exceptionMessage + "'" ) {
+
+      Areas areas;
+      InputCompressedFile input(compressedPath, GzipCompression);
+      REQUIRE_THROWS_WITH( areas.populateFromWelshStatsJSON(input.open(), cols), exceptionMessage );
+
+    } // THEN
+
+    std::remove(compressedPath.c_str());
+
+  } // GIVEN
+
+  GIVEN( "a compressed file that does not exist" ) {
+
+    InputCompressedFile input("doesnotexist.json.gz", GzipCompression);
+
+    const std::string exceptionMessage = "InputCompressedFile::open: Failed to open file doesnotexist.json.gz";
+
+    THEN( "a std::runtime_error is thrown with the message '" + exceptionMessage + "'" ) {
+
+      REQUIRE_THROWS_WITH( input.open(), exceptionMessage );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a zstd compressed dataset can be read without decompressing it to disk", "[InputCompressedFile][zstd]" ) {
+
+  const std::string compressedPath = "test19-popu1009.json.zst";
+
+#ifdef BETHYW_HAVE_ZSTD
+
+  const auto &cols = BethYw::InputFiles::DATASETS[0].COLS;
+  const std::string plain = fileContents("datasets/popu1009.json");
+
+  GIVEN( "popu1009.json compressed with zstd" ) {
+
+    std::string compressed(ZSTD_compressBound(plain.size()), '\0');
+    compressed.resize(ZSTD_compress(&compressed[0], compressed.size(), plain.data(), plain.size(), 3));
+    writeFile(compressedPath, compressed);
+
+    THEN( "the same data is imported as from the original file" ) {
+
+      Areas expected;
+      std::ifstream plainStream("datasets/popu1009.json");
+      expected.populateFromWelshStatsJSON(plainStream, cols);
+
+      Areas areas;
+      auto input = BethYw::createInputSource(compressedPath);
+      areas.populateFromWelshStatsJSON(input->open(), cols);
+      REQUIRE( areas.toJSON() == expected.toJSON() );
+
+    } // THEN
+
+    std::remove(compressedPath.c_str());
+
+  } // GIVEN
+
+  GIVEN( "zstd files whose frames end exactly as a decompressed block fills" ) {
+
+    const std::string block(256 * 1024, 'a');
+    auto zstdCompress = [](const std::string &contents) {
+      std::string compressed(ZSTD_compressBound(contents.size()), '\0');
+      compressed.resize(ZSTD_compress(&compressed[0], compressed.size(), contents.data(), contents.size(), 3));
+      return compressed;
+    };
+
+    THEN( "a single frame of one block is read to the end" ) {
+
+      writeFile(compressedPath, zstdCompress(block));
+      InputCompressedFile input(compressedPath, ZstdCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == block );
+
+    } // THEN
+
+    THEN( "a single frame of two blocks is read to the end" ) {
+
+      writeFile(compressedPath, zstdCompress(block + block));
+      InputCompressedFile input(compressedPath, ZstdCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == block + block );
+
+    } // THEN
+
+    THEN( "a short frame followed by a frame of one block is read to the end" ) {
+
+      const std::string head(1000, 'b');
+      writeFile(compressedPath, zstdCompress(head) + zstdCompress(block));
+      InputCompressedFile input(compressedPath, ZstdCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == head + block );
+
+    } // THEN
+
+    THEN( "a frame ending on a block boundary is followed by the next frame" ) {
+
+      const std::string head(1000, 'b');
+      writeFile(compressedPath, zstdCompress(head) + zstdCompress(block.substr(1000)) + zstdCompress(block));
+      InputCompressedFile input(compressedPath, ZstdCompression);
+      std::istream &stream = input.open();
+      REQUIRE( std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()) == head + block.substr(1000) + block );
+
+    } // THEN
+
+    std::remove(compressedPath.c_str());
+
+  } // GIVEN
+
+#else
+
+  GIVEN( "a zstd compressed file when zstd support is not built in" ) {
+
+    writeFile(compressedPath, std::string("\x28\xB5\x2F\xFD", 4));
+    InputCompressedFile input(compressedPath, detectCompression(compressedPath));
+
+    THEN( "a std::runtime_error is thrown when opening it" ) {
+
+      REQUIRE( input.getCompression() == ZstdCompression );
+      REQUIRE_THROWS_AS( input.open(), std::runtime_error );
+
+    } // THEN
+
+    std::remove(compressedPath.c_str());
+
+  } // GIVEN
+
+#endif // BETHYW_HAVE_ZSTD
+
+} // SCENARIO
@@ -0,0 +1,144 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../statswales.h"
+
+SCENARIO( "the odata.nextLink of a StatsWales page can be found without parsing it", "[paging][nextLink]" ) {
+
+  GIVEN( "a page with a nextLink containing escaped characters" ) {
+
+    const std::string page = "{\"value\":[{\"Data\":1}],\n  \"odata.nextLink\" : \"http:\\/\\/example\\/popu1009?%24skiptoken=1\"\n}";
+
+    THEN( "the unescaped link is returned" ) {
+
+      REQUIRE( findWelshStatsNextLink(page.data(), page.size()) == "http://example/popu1009?%24skiptoken=1" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "the last page of a dataset" ) {
+
+    std::ifstream file("datasets/tran0152.json");
+    const std::string page((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    THEN( "an empty link is returned" ) {
+
+      REQUIRE( findWelshStatsNextLink(page.data(), page.size()).empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "the first page of a dataset" ) {
+
+    std::ifstream file("datasets/popu1009.json");
+    const std::string page((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    THEN( "the link to the second page is returned" ) {
+
+      REQUIRE( findWelshStatsNextLink(page.data(), page.size()).find("dataset/popu1009?%24skiptoken=") != std::string::npos );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a StatsWales dataset split in to pages is imported page by page", "[paging][populateDataset]" ) {
+
+  GIVEN( "the path of the first page of a dataset" ) {
+
+    THEN( "later pages have their page number before the extension" ) {
+
+      REQUIRE( BethYw::pagePath("datasets/popu1009.json", 1) == "datasets/popu1009.json" );
+      REQUIRE( BethYw::pagePath("datasets/popu1009.json", 2) == "datasets/popu1009-2.json" );
+      REQUIRE( BethYw::pagePath("data.v2/popu1009.json.gz", 12) == "data.v2/popu1009-12.json.gz" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "popu1009.json saved as three pages linked with odata.nextLink" ) {
+
+    const std::string dir = "test20-";
+    BethYw::InputFileSource dataset = BethYw::InputFiles::POPDEN;
+
+    std::ifstream file("datasets/popu1009.json");
+    const std::string whole((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const std::size_t valueStart = whole.find('[') + 1;
+    const std::size_t valueEnd = whole.rfind(']');
+    const std::string header = whole.substr(0, valueStart);
+
+    // Split the rows at the first row boundaries after a third and two thirds
+    std::size_t first = whole.find("},", valueStart + (valueEnd - valueStart) / 3) + 1;
+    std::size_t second = whole.find("},", valueStart + 2 * (valueEnd - valueStart) / 3) + 1;
+
+    auto writePage = [&](const unsigned int number, std::size_t from, std::size_t to, bool last) {
+      std::ofstream page(BethYw::pagePath(dir + dataset.FILE, number));
+      page << header << whole.substr(from, to - from) << "]";
+      if (!last) {
+        page << ",\"odata.nextLink\":\"http://example/popu1009?page=" << number + 1 << "\"";
+      }
+      page << "}";
+    };
+    writePage(1, valueStart, first, false);
+    writePage(2, first + 1, second, false);
+    writePage(3, second + 1, valueEnd, true);
+
+    Areas expected;
+    std::ifstream stream("datasets/popu1009.json");
+    expected.populateFromWelshStatsJSON(stream, dataset.COLS);
+
+    const std::unordered_set<std::string> noFilter;
+    const std::tuple<unsigned int, unsigned int> noYears(0, 0);
+
+    THEN( "every page is imported and the result is the same as the whole file" ) {
+
+      Areas areas;
+      BethYw::populateDataset(areas, dir, dataset, noFilter, noFilter, noYears);
+      REQUIRE( areas.toJSON() == expected.toJSON() );
+
+    } // THEN
+
+    THEN( "only the first page is imported when the second is missing" ) {
+
+      std::remove(BethYw::pagePath(dir + dataset.FILE, 2).c_str());
+
+      Areas areas;
+      BethYw::populateDataset(areas, dir, dataset, noFilter, noFilter, noYears);
+      REQUIRE( areas.size() > 0 );
+      REQUIRE( areas.toJSON() != expected.toJSON() );
+
+    } // THEN
+
+    for (unsigned int number = 1; number <= 3; number++) {
+      std::remove(BethYw::pagePath(dir + dataset.FILE, number).c_str());
+    }
+
+  } // GIVEN
+
+} // SCENARIO
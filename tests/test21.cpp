@@ -0,0 +1,158 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../snapshot.h"
+
+SCENARIO( "a populated Areas instance can be saved to and loaded from a snapshot", "[Snapshot]" ) {
+
+  const std::string snapshotPath = "test21.snapshot";
+  const std::string sourcePath = "test21-popu1009.json";
+  const std::string key = "datasets=popden";
+
+  {
+    std::ifstream in("datasets/popu1009.json", std::ifstream::binary);
+    std::ofstream out(sourcePath, std::ofstream::binary);
+    out << in.rdbuf();
+  }
+  const std::vector<std::string> sources = {sourcePath};
+
+  Areas original;
+  {
+    std::ifstream stream(sourcePath);
+    original.populateFromWelshStatsJSON(stream, BethYw::InputFiles::POPDEN.COLS);
+  }
+
+  BethYw::Snapshot snapshot(snapshotPath);
+
+  GIVEN( "no snapshot file" ) {
+
+    std::remove(snapshotPath.c_str());
+
+    THEN( "nothing is loaded" ) {
+
+      Areas areas;
+      REQUIRE_FALSE( snapshot.load(areas, key, sources) );
+      REQUIRE( areas.size() == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a snapshot saved from the Areas instance" ) {
+
+    snapshot.save(original, key, sources);
+
+    THEN( "loading it with the same key and sources gives the same data" ) {
+
+      Areas areas;
+      REQUIRE( snapshot.load(areas, key, sources) );
+      REQUIRE( areas.size() == original.size() );
+      REQUIRE( areas.toJSON() == original.toJSON() );
+
+    } // THEN
+
+    THEN( "it is not loaded with a different key or different sources" ) {
+
+      Areas areas;
+      REQUIRE_FALSE( snapshot.load(areas, "datasets=aqi", sources) );
+      REQUIRE_FALSE( snapshot.load(areas, key, {}) );
+      REQUIRE_FALSE( snapshot.load(areas, key, {"datasets/popu1009.json"}) );
+      REQUIRE( areas.size() == 0 );
+
+    } // THEN
+
+    THEN( "it is still loaded after the source is rewritten with the same contents" ) {
+
+      std::string contents;
+      {
+        std::ifstream in(sourcePath, std::ifstream::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+      }
+      BethYw::SnapshotSource before;
+      REQUIRE( BethYw::statSource(sourcePath, before) );
+      BethYw::SnapshotSource after = before;
+      while (after.modified == before.modified) {
+        std::ofstream out(sourcePath, std::ofstream::binary | std::ofstream::trunc);
+        out << contents;
+        out.close();
+        REQUIRE( BethYw::statSource(sourcePath, after) );
+      }
+
+      Areas areas;
+      REQUIRE( snapshot.load(areas, key, sources) );
+      REQUIRE( areas.toJSON() == original.toJSON() );
+
+      AND_THEN( "the snapshot records the new modification time, and is still loaded" ) {
+
+        std::string saved;
+        {
+          std::ifstream in(snapshotPath, std::ifstream::binary);
+          saved.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        REQUIRE( saved.find(std::string(reinterpret_cast<const char*>(&after.modified), sizeof(after.modified))) != std::string::npos );
+        REQUIRE( saved.find(std::string(reinterpret_cast<const char*>(&before.modified), sizeof(before.modified))) == std::string::npos );
+
+        Areas reloaded;
+        REQUIRE( snapshot.load(reloaded, key, sources) );
+        REQUIRE( reloaded.toJSON() == original.toJSON() );
+
+      } // AND_THEN
+
+    } // THEN
+
+    THEN( "it is not loaded after the source changes" ) {
+
+      {
+        std::fstream out(sourcePath, std::fstream::in | std::fstream::out | std::fstream::binary);
+        out.seekp(100);
+        out.put('#');
+      }
+
+      Areas areas;
+      REQUIRE_FALSE( snapshot.load(areas, key, sources) );
+
+    } // THEN
+
+    THEN( "it is not loaded if it is corrupt" ) {
+
+      {
+        std::fstream out(snapshotPath, std::fstream::in | std::fstream::out | std::fstream::binary);
+        out.seekp(200);
+        out.put('#');
+      }
+
+      Areas areas;
+      REQUIRE_FALSE( snapshot.load(areas, key, sources) );
+
+    } // THEN
+
+    std::remove(snapshotPath.c_str());
+
+  } // GIVEN
+
+  std::remove(sourcePath.c_str());
+
+} // SCENARIO
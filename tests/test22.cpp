@@ -0,0 +1,124 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "../measure.h"
+
+SCENARIO( "a Measure keeps the same values however its years are spread", "[Measure][storage]" ) {
+
+  GIVEN( "a Measure with consecutive years set out of order, with a gap and an overwrite" ) {
+
+    Measure measure("Pop", "Population");
+    measure.setValue(2005, 5.0);
+    measure.setValue(2001, 1.0);
+    measure.setValue(2010, 10.0);
+    measure.setValue(2003, 3.0);
+    measure.setValue(2005, 50.0);
+
+    THEN( "the values can be retrieved by year and in order" ) {
+
+      REQUIRE( measure.size() == 4 );
+      REQUIRE( measure.getValue(2001) == 1.0 );
+      REQUIRE( measure.getValue(2005) == 50.0 );
+      REQUIRE( measure.getValues() == std::map<unsigned int, double>{{2001, 1.0}, {2003, 3.0}, {2005, 50.0}, {2010, 10.0}} );
+      REQUIRE( measure.getDifference() == Approx(9.0) );
+      REQUIRE( measure.getAverage() == Approx(16.0) );
+
+    } // THEN
+
+    THEN( "years in the gaps and outside the range have no value" ) {
+
+      REQUIRE_THROWS_AS( measure.getValue(2002), std::out_of_range );
+      REQUIRE_THROWS_AS( measure.getValue(2000), std::out_of_range );
+      REQUIRE_THROWS_WITH( measure.getValue(2011), "No value found for year 2011" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a Measure with widely scattered years" ) {
+
+    Measure measure("Pop", "Population");
+    measure.setValue(2019, 3.0);
+    measure.setValue(0, 1.0);
+    measure.setValue(4000000000u, 4.0);
+    measure.setValue(1991, 2.0);
+
+    THEN( "the values can be retrieved by year and in order" ) {
+
+      REQUIRE( measure.size() == 4 );
+      REQUIRE( measure.getValue(0) == 1.0 );
+      REQUIRE( measure.getValue(4000000000u) == 4.0 );
+      REQUIRE( measure.getValues() == std::map<unsigned int, double>{{0, 1.0}, {1991, 2.0}, {2019, 3.0}, {4000000000u, 4.0}} );
+      REQUIRE( measure.getDifference() == Approx(3.0) );
+      REQUIRE_THROWS_AS( measure.getValue(2000), std::out_of_range );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "random years and values also stored in a std::map" ) {
+
+    std::mt19937 random(1009);
+    for (unsigned int spread : {10u, 30u, 100u, 1000u}) {
+      Measure measure("Pop", "Population");
+      std::map<unsigned int, double> expected;
+      for (int i = 0; i < 40; i++) {
+        unsigned int year = 1900 + random() % spread;
+        double value = random() % 1000;
+        measure.setValue(year, value);
+        expected[year] = value;
+      }
+
+      THEN( "the Measure has the same values as the map (spread " + std::to_string(spread) + ")" ) {
+
+        REQUIRE( measure.getValues() == expected );
+        REQUIRE( measure.size() == static_cast<int>(expected.size()) );
+        for (auto &entry : expected) {
+          REQUIRE( measure.getValue(entry.first) == entry.second );
+        }
+        REQUIRE( measure.getDifference() == Approx(std::abs(expected.begin()->second - expected.rbegin()->second)) );
+
+      } // THEN
+
+    }
+
+  } // GIVEN
+
+  GIVEN( "two Measures combined with operator+" ) {
+
+    Measure lhs("Pop", "Population");
+    lhs.setValue(1991, 1.0);
+    lhs.setValue(1992, 2.0);
+    Measure rhs("Pop", "Population (new)");
+    rhs.setValue(1992, 20.0);
+    rhs.setValue(3000, 30.0);
+
+    THEN( "the right-hand values take precedence" ) {
+
+      Measure combined = lhs + rhs;
+      REQUIRE( combined.getLabel() == "Population (new)" );
+      REQUIRE( combined.getValues() == std::map<unsigned int, double>{{1991, 1.0}, {1992, 20.0}, {3000, 30.0}} );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,312 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../symbols.h"
+#include "../area.h"
+#include "../areas.h"
+
+SCENARIO( "strings can be interned as Symbols", "[Symbol][intern]" ) {
+
+  GIVEN( "a string interned twice from different copies" ) {
+
+    std::string first = "Population density (people per square kilometre)";
+    std::string second = first;
+
+    BethYw::Symbol a = BethYw::intern(first);
+    BethYw::Symbol b = BethYw::intern(second.data(), second.size());
+
+    THEN( "both Symbols are equal and share the same string" ) {
+
+      REQUIRE( a == b );
+      REQUIRE( &a.str() == &b.str() );
+      REQUIRE( a.str() == first );
+
+    } // THEN
+
+    THEN( "a different string gives a different Symbol" ) {
+
+      BethYw::Symbol c = BethYw::intern("Population");
+      REQUIRE( a != c );
+      REQUIRE( c.str() == "Population" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a default constructed Symbol" ) {
+
+    BethYw::Symbol empty;
+
+    THEN( "it is the Symbol for the empty string" ) {
+
+      REQUIRE( empty.empty() );
+      REQUIRE( empty == BethYw::intern("") );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a string that has never been interned" ) {
+
+    const std::string unseen = "test23: never interned";
+    BethYw::Symbol symbol;
+
+    THEN( "findSymbol() does not find it or add it to the table" ) {
+
+      REQUIRE_FALSE( BethYw::findSymbol(unseen, symbol) );
+      REQUIRE_FALSE( BethYw::findSymbol(unseen, symbol) );
+      REQUIRE( symbol.empty() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "Symbols ordered with SymbolOrder" ) {
+
+    BethYw::SymbolOrder order;
+    BethYw::Symbol pop = BethYw::intern("pop");
+    BethYw::Symbol dens = BethYw::intern("dens");
+
+    THEN( "they are ordered alphabetically by their strings" ) {
+
+      REQUIRE( order(dens, pop) );
+      REQUIRE_FALSE( order(pop, dens) );
+      REQUIRE_FALSE( order(pop, pop) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "Symbols ordered with SymbolHandleOrder" ) {
+
+    BethYw::SymbolHandleOrder order;
+    BethYw::Symbol pop = BethYw::intern("pop");
+    BethYw::Symbol dens = BethYw::intern("dens");
+
+    THEN( "different Symbols are ordered one way round, and equal ones neither" ) {
+
+      REQUIRE( order(dens, pop) != order(pop, dens) );
+      REQUIRE_FALSE( order(pop, pop) );
+      REQUIRE_FALSE( order(pop, BethYw::intern("pop")) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "strings interned and found on several threads at once" ) {
+
+    const std::vector<std::string> strings = {"test23: thread a", "test23: thread b", "test23: thread c"};
+    std::vector<std::vector<BethYw::Symbol>> found(4);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < found.size(); i++) {
+      threads.push_back(std::thread([&strings, &found, i]() {
+        for (int repeat = 0; repeat < 2; repeat++) {
+          for (auto& str : strings) {
+            BethYw::Symbol symbol = BethYw::intern(str);
+            BethYw::Symbol again;
+            BethYw::findSymbol(str, again);
+            found[i].push_back(symbol == again ? symbol : BethYw::Symbol());
+          }
+        }
+      }));
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    THEN( "every thread gets the same Symbol for each string" ) {
+
+      for (std::size_t i = 0; i < found.size(); i++) {
+        REQUIRE( found[i].size() == 2 * strings.size() );
+        for (std::size_t j = 0; j < found[i].size(); j++) {
+          REQUIRE( found[i][j] == BethYw::intern(strings[j % strings.size()]) );
+        }
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "Areas and Measures share interned codes and labels", "[Area][Measure][Symbol]" ) {
+
+  GIVEN( "two Areas with the same Measure" ) {
+
+    Areas areas;
+    Area first("W06000023");
+    Area second("W06000011");
+    first.setName("eng", "Powys");
+    second.setName("eng", "Swansea");
+
+    Measure measure("Pop", "Population");
+    measure.setValue(2015, 100);
+    first.setMeasure("Pop", measure);
+    second.setMeasure("POP", measure);
+
+    areas.setArea("W06000023", first);
+    areas.setArea("W06000011", second);
+
+    THEN( "the codes, labels and values can be looked up as before" ) {
+
+      REQUIRE( areas.size() == 2 );
+      REQUIRE( areas.getArea("W06000023").getName("eng") == "Powys" );
+      REQUIRE( areas.getArea("W06000011").getMeasure("pOp").getValue(2015) == 100 );
+      REQUIRE( areas.getArea("W06000011").getMeasure("pop").getLabel() == "Population" );
+
+    } // THEN
+
+    THEN( "looking up codes that were never interned throws std::out_of_range" ) {
+
+      REQUIRE_THROWS_AS( areas.getArea("test23: no such area"), std::out_of_range );
+      REQUIRE_THROWS_AS( first.getMeasure("test23: no such measure"), std::out_of_range );
+
+    } // THEN
+
+    THEN( "the Areas are still output in order of their codes" ) {
+
+      std::string json = areas.toJSON();
+      REQUIRE( json.find("W06000011") < json.find("W06000023") );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an Area whose codenames were interned in reverse alphabetical order" ) {
+
+    Area area("W06000011");
+    area.upsertMeasure("test23-zz", "Last").setValue(2015, 1);
+    area.upsertMeasure("test23-mm", "Middle").setValue(2015, 2);
+    area.upsertMeasure("test23-aa", "First").setValue(2015, 3);
+
+    THEN( "the Measures are still visited and output in order of codename" ) {
+
+      std::vector<std::string> codenames;
+      area.forEachMeasure([&codenames](const std::string& codename, const Measure& measure) {
+        codenames.push_back(codename);
+      });
+      REQUIRE( codenames == std::vector<std::string>{"test23-aa", "test23-mm", "test23-zz"} );
+
+      std::ostringstream output;
+      output << area;
+      REQUIRE( output.str().find("First") < output.str().find("Middle") );
+      REQUIRE( output.str().find("Middle") < output.str().find("Last") );
+
+    } // THEN
+
+    THEN( "Measures added by setMeasure(), merge() and to a copy are visited in order of codename" ) {
+
+      Area copy = area;
+      copy.setMeasure("test23-nn", Measure("test23-nn", "After middle"));
+      Area other("W06000011");
+      other.upsertMeasure("test23-bb", "Second").setValue(2015, 4);
+      other.upsertMeasure("test23-zz", "Last").setValue(2016, 5);
+      copy.merge(other);
+
+      std::vector<std::string> codenames;
+      copy.forEachMeasure([&codenames](const std::string& codename, const Measure& measure) {
+        codenames.push_back(codename);
+      });
+      REQUIRE( codenames == std::vector<std::string>{"test23-aa", "test23-bb", "test23-mm", "test23-nn", "test23-zz"} );
+      REQUIRE( copy.findMeasure("test23-zz")->size() == 2 );
+
+      codenames.clear();
+      area.forEachMeasure([&codenames](const std::string& codename, const Measure& measure) {
+        codenames.push_back(codename);
+      });
+      REQUIRE( codenames == std::vector<std::string>{"test23-aa", "test23-mm", "test23-zz"} );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "strings can be interned and found in lowercase without building a lowercase copy", "[Symbol][lowercase]" ) {
+
+  GIVEN( "a codename interned in lowercase" ) {
+
+    BethYw::Symbol codename = BethYw::internLowercase("TeSt23Dens");
+
+    THEN( "it is the Symbol for the lowercase string" ) {
+
+      REQUIRE( codename.str() == "test23dens" );
+      REQUIRE( codename == BethYw::intern("test23dens") );
+
+    } // THEN
+
+    THEN( "it can be found from any mix of cases" ) {
+
+      BethYw::Symbol found;
+      REQUIRE( BethYw::findLowercaseSymbol("TEST23DENS", found) );
+      REQUIRE( found == codename );
+      REQUIRE( BethYw::internLowercase(std::string("test23DENS")) == codename );
+
+    } // THEN
+
+    THEN( "a mixed case string interned as it is stays separate" ) {
+
+      BethYw::Symbol mixed = BethYw::intern("TeSt23Dens");
+      REQUIRE( mixed != codename );
+      REQUIRE( mixed.str() == "TeSt23Dens" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a lowercase string that has never been interned" ) {
+
+    BethYw::Symbol found;
+
+    THEN( "findLowercaseSymbol() does not find it, even if the mixed case string has been interned" ) {
+
+      BethYw::intern("Test23Unseen");
+      REQUIRE_FALSE( BethYw::findLowercaseSymbol("TEST23UNSEEN", found) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an Area with a Measure added on another thread" ) {
+
+    Area area("W06000011");
+    std::thread([&area]() {
+      area.upsertMeasure("Test23Threaded", "Threaded").setValue(2015, 1);
+    }).join();
+
+    THEN( "the Measure is found on this thread from any mix of cases" ) {
+
+      REQUIRE( area.findMeasure("TEST23THREADED") != nullptr );
+      REQUIRE( area.getMeasure("test23threaded").getLabel() == "Threaded" );
+
+    } // THEN
+
+    THEN( "a codename that was never interned is not found or added" ) {
+
+      BethYw::Symbol found;
+      REQUIRE( area.findMeasure("Test23NotThreaded") == nullptr );
+      REQUIRE_FALSE( BethYw::findLowercaseSymbol("test23notthreaded", found) );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
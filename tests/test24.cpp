@@ -0,0 +1,101 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../area.h"
+#include "../measure.h"
+
+SCENARIO( "the contents of an Area can be read without copying them", "[Area][Measure][view]" ) {
+
+  GIVEN( "an Area with two names and two Measures" ) {
+
+    Area area("W06000011");
+    area.setName("eng", "Swansea");
+    area.setName("cym", "Abertawe");
+
+    Measure pop("Pop", "Population");
+    pop.setValue(2011, 238700);
+    pop.setValue(2010, 237700);
+    Measure dens("Dens", "Population density");
+    dens.setValue(2010, 624.1);
+
+    area.setMeasure("Pop", pop);
+    area.setMeasure("Dens", dens);
+
+    THEN( "forEachName() visits the same names as getNames(), in order" ) {
+
+      std::map<std::string, std::string> names;
+      std::vector<std::string> langs;
+      area.forEachName([&](const std::string& lang, const std::string& name) {
+        names[lang] = name;
+        langs.push_back(lang);
+      });
+
+      REQUIRE( names == area.getNames() );
+      REQUIRE( langs == std::vector<std::string>{"cym", "eng"} );
+
+    } // THEN
+
+    THEN( "forEachMeasure() and forEachValue() visit the same data as the copying accessors" ) {
+
+      std::vector<std::string> codenames;
+      area.forEachMeasure([&](const std::string& codename, const Measure& measure) {
+        codenames.push_back(codename);
+        std::map<unsigned int, double> values;
+        measure.forEachValue([&](const unsigned int year, const double value) {
+          values[year] = value;
+        });
+        REQUIRE( values == measure.getValues() );
+      });
+
+      REQUIRE( codenames == std::vector<std::string>{"dens", "pop"} );
+
+    } // THEN
+
+    THEN( "the accessors for codes and labels return references that stay valid" ) {
+
+      const std::string& label = area.getMeasure("pop").getLabel();
+      const std::string& code = area.getLocalAuthorityCode();
+
+      REQUIRE( label == "Population" );
+      REQUIRE( code == "W06000011" );
+
+    } // THEN
+
+    THEN( "Areas and Measures compare equal to their copies and unequal when a value differs" ) {
+
+      Area copy = area;
+      REQUIRE( copy == area );
+
+      Measure changed = pop;
+      REQUIRE( changed == pop );
+      changed.setValue(2011, 1);
+      REQUIRE_FALSE( changed == pop );
+
+      Measure moreYears = pop;
+      moreYears.setValue(2012, 1);
+      REQUIRE_FALSE( moreYears == pop );
+      REQUIRE_FALSE( pop == moreYears );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,114 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../datasets.h"
+#include "../areas.h"
+
+SCENARIO( "Areas and Measures can be found or created and updated in place", "[Areas][Area][upsert]" ) {
+
+  GIVEN( "an Areas instance with one Area" ) {
+
+    Areas areas;
+    Area area("W06000011");
+    area.setName("eng", "Swansea");
+    areas.setArea("W06000011", area);
+
+    WHEN( "an existing Area is upserted" ) {
+
+      Area& found = areas.upsertArea("W06000011");
+
+      THEN( "the stored Area is returned and no Area is added" ) {
+
+        REQUIRE( areas.size() == 1 );
+        REQUIRE( &found == &areas.getArea("W06000011") );
+        REQUIRE( found.getName("eng") == "Swansea" );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "a new Area is upserted and given a Measure" ) {
+
+      Area& added = areas.upsertArea("W06000023");
+      added.upsertMeasure("Pop", "Population").setValue(2015, 1);
+      added.upsertMeasure("POP", "Population (thousands)").setValue(2016, 2);
+
+      THEN( "the Area is added with one Measure holding both values and the latest label" ) {
+
+        REQUIRE( areas.size() == 2 );
+        Measure& measure = areas.getArea("W06000023").getMeasure("pop");
+        REQUIRE( areas.getArea("W06000023").size() == 1 );
+        REQUIRE( measure.getLabel() == "Population (thousands)" );
+        REQUIRE( measure.getValue(2015) == 1 );
+        REQUIRE( measure.getValue(2016) == 2 );
+
+      } // THEN
+
+    } // WHEN
+
+    WHEN( "names are set again with language codes in any case" ) {
+
+      Area& found = areas.upsertArea("W06000011");
+      found.setName("ENG", "Swansea");
+      found.setName("Cym", "Abertawe");
+
+      THEN( "the names are stored under the lowercase codes" ) {
+
+        REQUIRE( found.getNames() == std::map<std::string, std::string>{{"cym", "Abertawe"}, {"eng", "Swansea"}} );
+
+      } // THEN
+
+      THEN( "an invalid language code is still rejected" ) {
+
+        REQUIRE_THROWS_AS( found.setName("en1", "Swansea"), std::invalid_argument );
+        REQUIRE_THROWS_AS( found.setName("engl", "Swansea"), std::invalid_argument );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a malformed row of an authority by year file is not partly imported", "[Areas][upsert][authorityByYearCSV]" ) {
+
+  const auto &cols = BethYw::InputFiles::DATASETS[5].COLS;
+
+  GIVEN( "a file whose second row has a value that is not a number" ) {
+
+    std::istringstream stream(
+      "AuthorityCode,2015,2016\n"
+      "W06000011,1,2\n"
+      "W06000023,3,x\n");
+    Areas areas;
+
+    THEN( "the rows before it are imported and the malformed row is not" ) {
+
+      REQUIRE_THROWS_AS( areas.populateFromAuthorityByYearCSV(stream, cols), std::runtime_error );
+      REQUIRE( areas.size() == 1 );
+      REQUIRE_THROWS_AS( areas.getArea("W06000023"), std::out_of_range );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
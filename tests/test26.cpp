@@ -0,0 +1,169 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "../arena.h"
+#include "../datasets.h"
+#include "../areas.h"
+
+SCENARIO( "memory can be allocated from an Arena", "[Arena]" ) {
+
+  GIVEN( "an Arena with small blocks" ) {
+
+    BethYw::Arena arena(256);
+
+    THEN( "allocations are aligned and counted" ) {
+
+      void* first = arena.allocate(3, 1);
+      void* second = arena.allocate(sizeof(double), alignof(double));
+      REQUIRE( first != second );
+      REQUIRE( reinterpret_cast<std::uintptr_t>(second) % alignof(double) == 0 );
+      REQUIRE( arena.getAllocated() == 3 + sizeof(double) );
+      REQUIRE( arena.getReserved() == 256 );
+
+    } // THEN
+
+    THEN( "an allocation larger than a block gets a block of its own" ) {
+
+      arena.allocate(1000, 8);
+      REQUIRE( arena.getReserved() == 1000 );
+      arena.allocate(8, 8);
+      REQUIRE( arena.getReserved() == 1256 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a std::map using an ArenaAllocator" ) {
+
+    auto arena = std::make_shared<BethYw::Arena>();
+    using Allocator = BethYw::ArenaAllocator<std::pair<const int, int>>;
+    std::map<int, int, std::less<int>, Allocator> values{Allocator(arena)};
+    for (int i = 0; i < 100; i++) {
+      values[i] = i * i;
+    }
+
+    THEN( "its nodes come from the Arena" ) {
+
+      REQUIRE( arena->getAllocated() >= 100 * sizeof(std::pair<const int, int>) );
+      REQUIRE( values[9] == 81 );
+
+    } // THEN
+
+    THEN( "a copy of it uses the heap and outlives the original" ) {
+
+      auto copy = std::unique_ptr<std::map<int, int, std::less<int>, Allocator>>(
+        new std::map<int, int, std::less<int>, Allocator>(values));
+      REQUIRE( copy->get_allocator().getArena() == nullptr );
+      values.clear();
+      arena.reset();
+      REQUIRE( copy->at(9) == 81 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "an Areas instance can allocate everything from an Arena", "[Areas][Arena]" ) {
+
+  GIVEN( "popu1009.json imported with and without an Arena, on several threads" ) {
+
+    const auto &cols = BethYw::InputFiles::DATASETS[0].COLS;
+    auto arena = std::make_shared<BethYw::Arena>();
+
+    Areas heapAreas;
+    Areas arenaAreas(arena);
+    arenaAreas.setParseThreads(3);
+
+    std::ifstream stream("datasets/popu1009.json");
+    std::ifstream arenaStream("datasets/popu1009.json");
+    heapAreas.populateFromWelshStatsJSON(stream, cols);
+    arenaAreas.populateFromWelshStatsJSON(arenaStream, cols);
+
+    THEN( "the same data is imported, and allocated from the Arena" ) {
+
+      REQUIRE( arenaAreas.getArena() == arena );
+      REQUIRE( heapAreas.getArena() == nullptr );
+      REQUIRE( arena->getAllocated() > 0 );
+      REQUIRE( heapAreas.toJSON() == arenaAreas.toJSON() );
+
+    } // THEN
+
+    THEN( "an Area copied out of the Arena outlives the Areas instance" ) {
+
+      Area copy = arenaAreas.getArea("W06000011");
+      std::string expected = heapAreas.getArea("W06000011").getMeasure("pop").getLabel();
+      arenaAreas = Areas();
+      arena.reset();
+      REQUIRE( copy.getMeasure("pop").getLabel() == expected );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an empty Areas instance with an Arena" ) {
+
+    const auto &cols = BethYw::InputFiles::DATASETS[0].COLS;
+    auto arena = std::make_shared<BethYw::Arena>();
+    Areas areas(arena);
+    const std::size_t empty = arena->getAllocated();
+
+    std::ifstream stream("datasets/popu1009.json");
+    areas.populateFromWelshStatsJSON(stream, cols);
+
+    THEN( "populating it allocates from the Arena" ) {
+
+      REQUIRE( arena->getAllocated() > empty );
+
+    } // THEN
+
+    THEN( "the imported Measures keep allocating from the Arena" ) {
+
+      Measure& measure = areas.getArea("W06000011").getMeasure("pop");
+      const std::size_t imported = arena->getAllocated();
+      for (unsigned int year = 2100; year < 2164; year++) {
+        measure.setValue(year, year);
+      }
+      REQUIRE( arena->getAllocated() > imported );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "an Areas instance with an Arena and a new Area" ) {
+
+    auto arena = std::make_shared<BethYw::Arena>();
+    Areas areas(arena);
+    Area& area = areas.upsertArea("W06000011");
+    const std::size_t allocated = arena->getAllocated();
+
+    THEN( "the names and Measures of the Area are allocated from the Arena" ) {
+
+      area.setName("eng", "Swansea");
+      area.upsertMeasure("pop", "Population").setValue(2010, 1);
+      REQUIRE( arena->getAllocated() > allocated );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
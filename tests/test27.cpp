@@ -0,0 +1,111 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../facts.h"
+
+SCENARIO( "the readings of an Areas instance can be scanned as a fact table", "[FactTable]" ) {
+
+  GIVEN( "an Areas instance with two areas and two measures" ) {
+
+    Areas areas;
+    Area swansea("W06000011");
+    swansea.upsertMeasure("Pop", "Population").setValue(2015, 100);
+    swansea.upsertMeasure("Pop", "Population").setValue(2016, 110);
+    swansea.upsertMeasure("Dens", "Population density").setValue(2015, 5);
+    Area powys("W06000023");
+    powys.upsertMeasure("Pop", "Population").setValue(2015, 40);
+    areas.setArea("W06000023", powys);
+    areas.setArea("W06000011", swansea);
+
+    BethYw::FactTable facts(areas);
+
+    THEN( "every reading is a row, ordered by area, measure and year" ) {
+
+      REQUIRE( facts.size() == 4 );
+      REQUIRE( facts.numAreas() == 2 );
+      REQUIRE( facts.numMeasures() == 2 );
+      REQUIRE( facts.getAreaCode(facts.getAreaIds()[0]) == "W06000011" );
+      REQUIRE( facts.getMeasureCodename(facts.getMeasureIds()[0]) == "dens" );
+      REQUIRE( facts.getYears() == std::vector<unsigned int>{2015, 2015, 2016, 2015} );
+      REQUIRE( facts.getValues() == std::vector<double>{5, 100, 110, 40} );
+
+    } // THEN
+
+    THEN( "codes can be looked up in the dictionaries" ) {
+
+      std::uint32_t id = 99;
+      REQUIRE( facts.findMeasure("POP", id) );
+      REQUIRE( facts.getMeasureCodename(id) == "pop" );
+      REQUIRE( facts.findArea("W06000023", id) );
+      REQUIRE( facts.getAreaCode(id) == "W06000023" );
+      REQUIRE_FALSE( facts.findArea("test27: no such area", id) );
+      REQUIRE_THROWS_AS( facts.getAreaCode(2), std::out_of_range );
+
+    } // THEN
+
+    THEN( "a measure can be aggregated across every area" ) {
+
+      std::uint32_t pop = 0;
+      REQUIRE( facts.findMeasure("pop", pop) );
+      REQUIRE( facts.count(pop, 2015, 2015) == 2 );
+      REQUIRE( facts.sum(pop, 2015, 2015) == 140 );
+      REQUIRE( facts.average(pop, 2015, 2016) == Approx(250.0 / 3) );
+      REQUIRE( facts.average(pop, 1990, 1991) == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "popu1009.json" ) {
+
+    Areas areas;
+    std::ifstream stream("datasets/popu1009.json");
+    areas.populateFromWelshStatsJSON(stream, BethYw::InputFiles::DATASETS[0].COLS);
+    BethYw::FactTable facts(areas);
+
+    THEN( "the sum of a measure in the fact table matches the sum over every Area" ) {
+
+      double expected = 0;
+      std::size_t readings = 0;
+      areas.forEachArea([&](const Area& area) {
+        area.forEachMeasure([&](const std::string& codename, const Measure& measure) {
+          readings += measure.size();
+          if (codename == "pop") {
+            measure.forEachValue([&](const unsigned int year, const double value) {
+              if (year == 2010) {
+                expected += value;
+              }
+            });
+          }
+        });
+      });
+
+      std::uint32_t pop = 0;
+      REQUIRE( facts.findMeasure("pop", pop) );
+      REQUIRE( facts.size() == readings );
+      REQUIRE( facts.sum(pop, 2010, 2010) == Approx(expected) );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
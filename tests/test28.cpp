@@ -0,0 +1,169 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../authority.h"
+#include "../areas.h"
+
+SCENARIO( "ONS area codes can be encoded in 32 bits", "[AuthorityCode]" ) {
+
+  GIVEN( "standard codes" ) {
+
+    auto first = BethYw::AuthorityCode::parse("W06000001");
+    auto last = BethYw::AuthorityCode::parse("Z99999999");
+    auto small = BethYw::AuthorityCode::parse("A00000000");
+
+    THEN( "they are encoded as a letter and a number and formatted back" ) {
+
+      REQUIRE( first.isStandard() );
+      REQUIRE( first.getValue() == ((23u << 27) | 6000001u) );
+      REQUIRE( first.str() == "W06000001" );
+      REQUIRE( last.str() == "Z99999999" );
+      REQUIRE( small.str() == "A00000000" );
+      REQUIRE( small.isStandard() );
+
+    } // THEN
+
+    THEN( "they are equal only to the same code" ) {
+
+      REQUIRE( first == BethYw::AuthorityCode::parse(std::string("W06000001")) );
+      REQUIRE( first != BethYw::AuthorityCode::parse("W06000002") );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "codes that are not standard" ) {
+
+    auto lowercase = BethYw::AuthorityCode::parse("w06000001");
+    auto shortCode = BethYw::AuthorityCode::parse("AREA1");
+    auto longCode = BethYw::AuthorityCode::parse("W060000011");
+
+    THEN( "they fall back to the table and are formatted back" ) {
+
+      REQUIRE_FALSE( lowercase.isStandard() );
+      REQUIRE_FALSE( shortCode.isStandard() );
+      REQUIRE_FALSE( longCode.isStandard() );
+      REQUIRE( lowercase.str() == "w06000001" );
+      REQUIRE( shortCode.str() == "AREA1" );
+      REQUIRE( longCode.str() == "W060000011" );
+      REQUIRE( shortCode == BethYw::AuthorityCode::parse("AREA1") );
+      REQUIRE( lowercase != BethYw::AuthorityCode::parse("W06000001") );
+
+    } // THEN
+
+    THEN( "find() does not add a code that has never been seen" ) {
+
+      BethYw::AuthorityCode code;
+      REQUIRE( BethYw::AuthorityCode::find("AREA1", code) );
+      REQUIRE( code == shortCode );
+      REQUIRE_FALSE( BethYw::AuthorityCode::find("test28: never seen", code) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "non-standard codes added on several threads while others are compared" ) {
+
+    const std::size_t threads = 4;
+    const std::size_t perThread = 600;
+    std::vector<std::vector<BethYw::AuthorityCode>> codes(threads);
+    std::vector<std::size_t> misordered(threads, 0);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+      workers.push_back(std::thread([t, perThread, &codes, &misordered]() {
+        BethYw::AuthorityCodeOrder order;
+        for (std::size_t i = 0; i < perThread; i++) {
+          codes[t].push_back(BethYw::AuthorityCode::parse("test28-" + std::to_string(t) + "-" + std::to_string(1000 + i)));
+          if (i > 0 && !order(codes[t][i - 1], codes[t][i])) {
+            misordered[t]++;
+          }
+        }
+      }));
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    THEN( "every code is formatted back and ordered alphabetically" ) {
+
+      for (std::size_t t = 0; t < threads; t++) {
+        REQUIRE( misordered[t] == 0 );
+        for (std::size_t i = 0; i < perThread; i++) {
+          REQUIRE( codes[t][i].str() == "test28-" + std::to_string(t) + "-" + std::to_string(1000 + i) );
+        }
+        BethYw::AuthorityCode found;
+        REQUIRE( BethYw::AuthorityCode::find("test28-" + std::to_string(t) + "-1000", found) );
+        REQUIRE( found == codes[t][0] );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a mix of standard and non-standard codes" ) {
+
+    std::vector<std::string> strings = {"W06000023", "AREA1", "W06000002", "W060000011", "E01000001", "W06", "w06000001", ""};
+    std::vector<BethYw::AuthorityCode> codes;
+    for (auto& str : strings) {
+      codes.push_back(BethYw::AuthorityCode::parse(str));
+    }
+
+    THEN( "they are ordered alphabetically" ) {
+
+      std::sort(strings.begin(), strings.end());
+      std::sort(codes.begin(), codes.end(), BethYw::AuthorityCodeOrder());
+      for (std::size_t i = 0; i < strings.size(); i++) {
+        REQUIRE( codes[i].str() == strings[i] );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "an Areas instance is keyed by encoded authority codes", "[Areas][AuthorityCode]" ) {
+
+  GIVEN( "Areas with standard and non-standard codes" ) {
+
+    Areas areas;
+    areas.setArea("W06000023", Area("W06000023"));
+    areas.setArea("AREA1", Area("AREA1"));
+    areas.setArea("W06000002", Area("W06000002"));
+
+    THEN( "they can be found and are output in alphabetical order" ) {
+
+      REQUIRE( areas.size() == 3 );
+      REQUIRE( areas.getArea("AREA1").getLocalAuthorityCode() == "AREA1" );
+      REQUIRE( areas.getArea("W06000002").getLocalAuthorityCode() == "W06000002" );
+      REQUIRE_THROWS_AS( areas.getArea("W06000099"), std::out_of_range );
+
+      std::vector<std::string> order;
+      areas.forEachArea([&order](const Area& area) {
+        order.push_back(area.getLocalAuthorityCode());
+      });
+      REQUIRE( order == std::vector<std::string>{"AREA1", "W06000002", "W06000023"} );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,94 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+
+#include "../authority.h"
+#include "../flatmap.h"
+
+SCENARIO( "a FlatMap can stand in for a std::map while importing", "[FlatMap]" ) {
+
+  using CodeMap = BethYw::FlatMap<BethYw::AuthorityCode, std::string, BethYw::AuthorityCodeHash>;
+
+  GIVEN( "a FlatMap with many consecutive area codes" ) {
+
+    CodeMap map;
+    for (unsigned int i = 0; i < 5000; i++) {
+      std::string code = std::to_string(6000000 + i);
+      code = "W0" + code;
+      map.insert(std::make_pair(BethYw::AuthorityCode::parse(code), code));
+    }
+
+    THEN( "every code can be found" ) {
+
+      REQUIRE( map.size() == 5000 );
+      for (unsigned int i = 0; i < 5000; i += 7) {
+        std::string code = "W0" + std::to_string(6000000 + i);
+        auto it = map.find(BethYw::AuthorityCode::parse(code));
+        REQUIRE( it != map.end() );
+        REQUIRE( it->second == code );
+      }
+      REQUIRE( map.count(BethYw::AuthorityCode::parse("W06999999")) == 0 );
+
+    } // THEN
+
+    THEN( "inserting a code that is already there keeps the existing entry" ) {
+
+      auto result = map.insert(std::make_pair(BethYw::AuthorityCode::parse("W06000001"), std::string("other")));
+      REQUIRE_FALSE( result.second );
+      REQUIRE( result.first->second == "W06000001" );
+      REQUIRE( map.size() == 5000 );
+
+    } // THEN
+
+    THEN( "a copy holds the same entries and clearing the map empties it" ) {
+
+      CodeMap copy;
+      copy = map;
+      map.clear();
+      REQUIRE( map.empty() );
+      REQUIRE( map.find(BethYw::AuthorityCode::parse("W06000001")) == map.end() );
+      REQUIRE( copy.size() == 5000 );
+      REQUIRE( copy.find(BethYw::AuthorityCode::parse("W06000001"))->second == "W06000001" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a reference to an entry in a FlatMap" ) {
+
+    CodeMap map;
+    auto first = map.insert(std::make_pair(BethYw::AuthorityCode::parse("W06000001"), std::string("first")));
+    std::string& value = first.first->second;
+
+    WHEN( "the map grows" ) {
+
+      for (unsigned int i = 2; i < 1000; i++) {
+        map.insert(std::make_pair(BethYw::AuthorityCode::parse("W0" + std::to_string(6000000 + i)), std::string("x")));
+      }
+
+      THEN( "the reference is still valid" ) {
+
+        REQUIRE( &value == &map.find(BethYw::AuthorityCode::parse("W06000001"))->second );
+        REQUIRE( value == "first" );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,165 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../memory.h"
+
+SCENARIO( "the memory used by a Measure can be estimated", "[Measure][memory]" ) {
+
+  GIVEN( "a Measure with no readings" ) {
+
+    Measure measure("pop", "Population");
+    const BethYw::MemoryUsage empty = measure.getMemoryUsage();
+
+    THEN( "only the object itself is counted" ) {
+
+      REQUIRE( empty.measures == sizeof(Measure) );
+      REQUIRE( empty.values == 0 );
+      REQUIRE( empty.total() == sizeof(Measure) );
+
+    } // THEN
+
+    WHEN( "readings for consecutive years are added" ) {
+
+      for (unsigned int year = 1990; year < 2020; year++) {
+        measure.setValue(year, year);
+      }
+
+      THEN( "at least a double per reading is counted" ) {
+
+        REQUIRE( measure.getMemoryUsage().values >= 30 * sizeof(double) );
+        REQUIRE( measure.getMemoryUsage().measures == sizeof(Measure) );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "the memory used by Areas can be estimated", "[Areas][memory]" ) {
+
+  GIVEN( "an Areas instance with two Areas sharing a Measure" ) {
+
+    Areas areas;
+    for (const std::string code : {"W06000011", "W06000012"}) {
+      Area& area = areas.upsertArea(code);
+      area.setName("eng", "Area " + code);
+      area.upsertMeasure("pop", "Population").setValue(2010, 1);
+    }
+
+    const BethYw::MemoryUsage usage = areas.getMemoryUsage();
+
+    THEN( "every part of the usage is counted" ) {
+
+      REQUIRE( usage.names > 0 );
+      REQUIRE( usage.measures >= 2 * sizeof(Measure) );
+      REQUIRE( usage.values >= 2 * sizeof(double) );
+      REQUIRE( usage.overhead >= 2 * sizeof(Area) );
+      REQUIRE( usage.total() == usage.names + usage.measures + usage.values + usage.strings + usage.overhead );
+
+    } // THEN
+
+    THEN( "the strings the Areas share are counted once" ) {
+
+      BethYw::MemoryUsage summed;
+      areas.forEachArea([&summed](const Area& area) {
+        summed += area.getMemoryUsage();
+      });
+
+      // Two codes, two names, and the codename and label of "pop"
+      REQUIRE( usage.strings < summed.strings );
+      REQUIRE( usage.strings >= 6 * sizeof(std::string) );
+
+    } // THEN
+
+    THEN( "only the Areas estimate, which collects the strings in a set, may throw" ) {
+
+      const Area& area = areas.getArea("W06000011");
+      REQUIRE_FALSE( noexcept(areas.getMemoryUsage()) );
+      REQUIRE( noexcept(area.getMemoryUsage()) );
+
+    } // THEN
+
+    WHEN( "a reading is added" ) {
+
+      areas.getArea("W06000011").getMeasure("pop").setValue(2011, 2);
+
+      THEN( "the growth is reported as values" ) {
+
+        const BethYw::MemoryUsage added = areas.getMemoryUsage().since(usage);
+        REQUIRE( added.names == 0 );
+        REQUIRE( added.strings == 0 );
+        REQUIRE( added.values > 0 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+  GIVEN( "the popden and trains datasets loaded with their usage recorded" ) {
+
+    Areas areas;
+    std::vector<BethYw::InputFileSource> datasets = {
+      BethYw::InputFiles::POPDEN,
+      BethYw::InputFiles::TRAINS
+    };
+    std::vector<BethYw::MemoryUsage> datasetUsage;
+
+    REQUIRE( BethYw::loadDatasets(areas,
+      "datasets/",
+      datasets,
+      std::unordered_set<std::string>(),
+      std::unordered_set<std::string>(),
+      std::make_tuple(0u, 0u),
+      false,
+      1,
+      &datasetUsage) );
+
+    THEN( "there is a row for areas.csv and each dataset" ) {
+
+      REQUIRE( datasetUsage.size() == 3 );
+      REQUIRE( datasetUsage[0].names > 0 );
+      REQUIRE( datasetUsage[1].values > 0 );
+      REQUIRE( datasetUsage[2].values > 0 );
+
+    } // THEN
+
+    THEN( "the report names each dataset and the total" ) {
+
+      std::ostringstream report;
+      BethYw::printMemoryReport(report, areas, datasets, datasetUsage);
+
+      REQUIRE( report.str().find("areas.csv") != std::string::npos );
+      REQUIRE( report.str().find(datasets[0].CODE) != std::string::npos );
+      REQUIRE( report.str().find(datasets[1].CODE) != std::string::npos );
+      REQUIRE( report.str().find("Total") != std::string::npos );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,246 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../bethyw.h"
+#include "../filters.h"
+
+SCENARIO( "a StringFilter can be compiled from a set of strings", "[StringFilter]" ) {
+
+  GIVEN( "a filter compiled from strings in mixed case" ) {
+
+    StringFilterSet values = {"POP", "Dens", "swan"};
+    const BethYw::StringFilter filter(values);
+
+    THEN( "values are looked up ignoring case" ) {
+
+      REQUIRE_FALSE( filter.matchesAll() );
+      REQUIRE( filter.size() == 3 );
+      REQUIRE( filter.contains("pop") );
+      REQUIRE( filter.contains("DENS") );
+      REQUIRE_FALSE( filter.contains("po") );
+      REQUIRE_FALSE( filter.contains("area") );
+
+    } // THEN
+
+    THEN( "parts of values are matched ignoring case" ) {
+
+      REQUIRE( filter.containsPartOf("City and County of Swansea") );
+      REQUIRE( filter.containsPartOf("Population") );
+      REQUIRE_FALSE( filter.containsPartOf("Cardiff") );
+      REQUIRE_FALSE( filter.containsPartOf("") );
+
+    } // THEN
+
+    THEN( "changing the set does not change the filter" ) {
+
+      values.clear();
+      REQUIRE( filter.contains("pop") );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "filters compiled from an empty set and a null pointer" ) {
+
+    const BethYw::StringFilter empty = StringFilterSet();
+    const BethYw::StringFilter null = static_cast<const StringFilterSet*>(nullptr);
+
+    THEN( "they match everything" ) {
+
+      REQUIRE( empty.matchesAll() );
+      REQUIRE( null.matchesAll() );
+      REQUIRE( empty.contains("anything") );
+      REQUIRE( null.containsPartOf("") );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a StringFilter searches for every key at once", "[StringFilter][automaton]" ) {
+
+  GIVEN( "a filter with keys that overlap and are suffixes of each other" ) {
+
+    const BethYw::StringFilter filter(StringFilterSet{"he", "SHE", "his", "hers", "W0600002"});
+
+    THEN( "each key is found anywhere in a value, ignoring case" ) {
+
+      REQUIRE( filter.containsPartOf("usher") );
+      REQUIRE( filter.containsPartOf("aHIS") );
+      REQUIRE( filter.containsPartOf("w06000021") );
+      REQUIRE( filter.containsPartOf("xxhExx") );
+      REQUIRE_FALSE( filter.containsPartOf("hi") );
+      REQUIRE_FALSE( filter.containsPartOf("W0600001") );
+      REQUIRE_FALSE( filter.containsPartOf("Ynys M\xc3\xb4n") );
+
+    } // THEN
+
+    THEN( "the result is the same as searching for each key in turn" ) {
+
+      const std::string keys[] = {"he", "she", "his", "hers", "w0600002"};
+      const std::string alphabet = "hersiHERSxW0612";
+      unsigned int seed = 12345;
+      for (int i = 0; i < 2000; i++) {
+        std::string value;
+        seed = seed * 1103515245 + 12345;
+        std::size_t length = (seed >> 16) % 12;
+        for (std::size_t j = 0; j < length; j++) {
+          seed = seed * 1103515245 + 12345;
+          value += alphabet[(seed >> 16) % alphabet.size()];
+        }
+
+        std::string lowercase = BethYw::toLowercase(value);
+        bool expected = false;
+        for (const std::string& key : keys) {
+          expected = expected || lowercase.find(key) != std::string::npos;
+        }
+        REQUIRE( filter.containsPartOf(value) == expected );
+      }
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a filter with an empty key" ) {
+
+    const BethYw::StringFilter filter(StringFilterSet{"", "swan"});
+
+    THEN( "every value but an empty one is matched" ) {
+
+      REQUIRE( filter.containsPartOf("Cardiff") );
+      REQUIRE_FALSE( filter.containsPartOf("") );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "a YearFilter can be compiled from a tuple of years", "[YearFilter]" ) {
+
+  GIVEN( "a filter for 2010 to 2015" ) {
+
+    const BethYw::YearFilter filter(std::make_tuple(2010u, 2015u));
+
+    THEN( "only years in the range are matched" ) {
+
+      REQUIRE_FALSE( filter.matchesAll() );
+      REQUIRE( filter.contains(2010) );
+      REQUIRE( filter.contains(2015) );
+      REQUIRE_FALSE( filter.contains(2009) );
+      REQUIRE_FALSE( filter.contains(2016) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "filters for <0,0>, <0,2015> and a null pointer" ) {
+
+    const BethYw::YearFilter zero(std::make_tuple(0u, 0u));
+    const BethYw::YearFilter open(0, 2015);
+    const BethYw::YearFilter null = static_cast<const YearFilterTuple*>(nullptr);
+
+    THEN( "every year is matched" ) {
+
+      REQUIRE( zero.matchesAll() );
+      REQUIRE( open.matchesAll() );
+      REQUIRE( null.matchesAll() );
+      REQUIRE( zero.contains(1900) );
+      REQUIRE( open.getFirst() == 0 );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "an Areas instance can be populated with compiled filters", "[Areas][StringFilter][YearFilter]" ) {
+
+  GIVEN( "a by-year CSV file and compiled filters" ) {
+
+    const std::string csv =
+      "AuthorityCode,1991,1992,1993\n"
+      "W06000001,1,2,3\n"
+      "W06000002,4,5,6\n";
+    const auto &cols = BethYw::InputFiles::COMPLETE_POPDEN.COLS;
+
+    const BethYw::StringFilter areasFilter(StringFilterSet{"w06000002"});
+    const BethYw::StringFilter measuresFilter(StringFilterSet{"DENS"});
+    const BethYw::YearFilter yearsFilter(1992, 1993);
+
+    WHEN( "the file is imported" ) {
+
+      std::istringstream stream(csv);
+      Areas areas;
+      areas.populateFromAuthorityByYearCSV(stream, cols, areasFilter, measuresFilter, yearsFilter);
+
+      THEN( "only the matching area and years are imported" ) {
+
+        REQUIRE( areas.size() == 1 );
+        const Measure& measure = areas.getArea("W06000002").getMeasure("dens");
+        REQUIRE( measure.size() == 2 );
+        REQUIRE( measure.getValue(1992) == 5 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+  GIVEN( "StatsWales rows for an area first under a name outside the filter" ) {
+
+    std::istringstream stream(
+      "{\"value\":["
+      "{\"Data\":1,\"Localauthority_Code\":\"W06000011\",\"Localauthority_ItemName_ENG\":\"Old name\","
+      "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"2010\"},"
+      "{\"Data\":2,\"Localauthority_Code\":\"W06000011\",\"Localauthority_ItemName_ENG\":\"Old name\","
+      "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"2011\"},"
+      "{\"Data\":3,\"Localauthority_Code\":\"W06000011\",\"Localauthority_ItemName_ENG\":\"Swansea\","
+      "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"2012\"},"
+      "{\"Data\":4,\"Localauthority_Code\":\"W06000011\",\"Localauthority_ItemName_ENG\":\"Old name\","
+      "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Year_Code\":\"2013\"}"
+      "]}");
+
+    const BethYw::StringFilter areasFilter(StringFilterSet{"swan"});
+
+    WHEN( "the rows are imported" ) {
+
+      Areas areas;
+      areas.populateFromWelshStatsJSON(stream, BethYw::InputFiles::POPDEN.COLS, areasFilter);
+
+      THEN( "the rows from when the name matches are imported, and every row after" ) {
+
+        REQUIRE( areas.size() == 1 );
+        const Measure& measure = areas.getArea("W06000011").getMeasure("pop");
+        REQUIRE( measure.size() == 2 );
+        REQUIRE( measure.getValue(2012) == 3 );
+        REQUIRE( measure.getValue(2013) == 4 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,81 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <string>
+
+#include "../areas.h"
+
+SCENARIO( "Areas, Area and Measure can be searched without exceptions", "[Areas][Area][Measure][find]" ) {
+
+  GIVEN( "an Areas instance with an Area that has a name and a Measure" ) {
+
+    Areas areas;
+    Area& area = areas.upsertArea("W06000011");
+    area.setName("eng", "Swansea");
+    area.upsertMeasure("pop", "Population").setValue(2010, 238700);
+
+    THEN( "what exists is found" ) {
+
+      Area* found = areas.findArea("W06000011");
+      REQUIRE( found == &area );
+
+      const Areas& constAreas = areas;
+      REQUIRE( constAreas.findArea("W06000011") == &area );
+
+      REQUIRE( area.findName("eng") != nullptr );
+      REQUIRE( *area.findName("eng") == "Swansea" );
+
+      Measure* measure = area.findMeasure("POP");
+      REQUIRE( measure != nullptr );
+      REQUIRE( measure == &area.getMeasure("pop") );
+
+      double value = 0;
+      REQUIRE( measure->tryGetValue(2010, value) );
+      REQUIRE( value == 238700 );
+      REQUIRE( *measure->findValue(2010) == 238700 );
+
+    } // THEN
+
+    THEN( "what does not exist is reported without throwing" ) {
+
+      REQUIRE_NOTHROW( areas.findArea("W06000099") );
+      REQUIRE( areas.findArea("W06000099") == nullptr );
+      REQUIRE( areas.findArea("") == nullptr );
+      REQUIRE( areas.findArea("never seen before") == nullptr );
+
+      REQUIRE( area.findName("cym") == nullptr );
+      REQUIRE( area.findMeasure("dens") == nullptr );
+      REQUIRE( area.findMeasure("never seen before") == nullptr );
+
+      double value = 1;
+      REQUIRE_FALSE( area.getMeasure("pop").tryGetValue(2011, value) );
+      REQUIRE( value == 1 );
+      REQUIRE( area.getMeasure("pop").findValue(2011) == nullptr );
+
+    } // THEN
+
+    THEN( "the throwing accessors still throw" ) {
+
+      REQUIRE_THROWS_AS( areas.getArea("W06000099"), std::out_of_range );
+      REQUIRE_THROWS_AS( area.getName("cym"), std::out_of_range );
+      REQUIRE_THROWS_AS( area.getMeasure("dens"), std::out_of_range );
+      REQUIRE_THROWS_AS( area.getMeasure("pop").getValue(2011), std::out_of_range );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,140 @@
+
+
+
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../datasets.h"
+#include "../areas.h"
+#include "../filters.h"
+#include "../statswales.h"
+
+SCENARIO( "a StatsWales row can be rejected part way through", "[WelshStatsHandler][pushdown]" ) {
+
+  const auto &cols = BethYw::InputFiles::POPDEN.COLS;
+
+  const std::string document =
+    "{\"value\":["
+    "{\"Year_Code\":\"1997\",\"Localauthority_Code\":\"W06000001\",\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\","
+    "\"Measure_Code\":\"Dens\",\"Measure_ItemName_ENG\":\"Population density\",\"Data\":1.5},"
+    "{\"Year_Code\":\"2019\",\"Localauthority_Code\":\"W06000002\",\"Localauthority_ItemName_ENG\":\"Gwynedd\","
+    "\"Measure_Code\":\"Pop\",\"Measure_ItemName_ENG\":\"Population\",\"Data\":\"2\"}"
+    "]}";
+
+  GIVEN( "a handler that rejects rows before 2000 once their year is read" ) {
+
+    std::vector<WelshStatsRow> rows;
+    std::vector<unsigned int> reads;
+    WelshStatsHandler handler(cols,
+      [&](const WelshStatsRow &row) { rows.push_back(row); },
+      [&](const WelshStatsRow &row, const unsigned int read) {
+        reads.push_back(read);
+        return !(read & WelshStatsHandler::YEAR) || row.year >= 2000;
+      });
+
+    THEN( "the rejected row is not handed on, and is not read any further" ) {
+
+      REQUIRE( handler.parse(document.data(), document.size()) );
+      REQUIRE( rows.size() == 1 );
+      REQUIRE( rows[0].authCode == "W06000002" );
+      REQUIRE( rows[0].value == 2 );
+
+      // The first row is checked once, then once per checked field of the second
+      REQUIRE( reads.size() == 1 + 4 );
+      REQUIRE( reads[0] == WelshStatsHandler::YEAR );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a rejected row with a malformed value" ) {
+
+    const std::string malformed =
+      "{\"value\":[{\"Year_Code\":\"1997\",\"Localauthority_Code\":\"W06000001\","
+      "\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\",\"Measure_Code\":\"Dens\","
+      "\"Measure_ItemName_ENG\":\"Population density\",\"Data\":\"not a number\"}]}";
+
+    WelshStatsHandler handler(cols,
+      [](const WelshStatsRow &) {},
+      [](const WelshStatsRow &, const unsigned int) { return false; });
+
+    THEN( "the document is still reported as malformed" ) {
+
+      REQUIRE_FALSE( handler.parse(malformed.data(), malformed.size()) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a rejected row missing a mapped key" ) {
+
+    const std::string missing = "{\"value\":[{\"Year_Code\":\"1997\",\"Data\":1.0}]}";
+
+    WelshStatsHandler handler(cols,
+      [](const WelshStatsRow &) {},
+      [](const WelshStatsRow &, const unsigned int) { return false; });
+
+    THEN( "the document is still reported as malformed" ) {
+
+      REQUIRE_FALSE( handler.parse(missing.data(), missing.size()) );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "an Areas instance skips StatsWales rows outside the filters", "[Areas][pushdown]" ) {
+
+  const auto &cols = BethYw::InputFiles::POPDEN.COLS;
+
+  GIVEN( "rows for two areas in and out of the years filter" ) {
+
+    std::istringstream stream(
+      "{\"value\":["
+      "{\"Year_Code\":\"1997\",\"Localauthority_Code\":\"W06000001\",\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\","
+      "\"Measure_Code\":\"Dens\",\"Measure_ItemName_ENG\":\"Population density\",\"Data\":1},"
+      "{\"Year_Code\":\"2019\",\"Localauthority_Code\":\"W06000001\",\"Localauthority_ItemName_ENG\":\"Isle of Anglesey\","
+      "\"Measure_Code\":\"Dens\",\"Measure_ItemName_ENG\":\"Population density\",\"Data\":2},"
+      "{\"Year_Code\":\"1998\",\"Localauthority_Code\":\"W06000002\",\"Localauthority_ItemName_ENG\":\"Gwynedd\","
+      "\"Measure_Code\":\"Dens\",\"Measure_ItemName_ENG\":\"Population density\",\"Data\":3},"
+      "{\"Year_Code\":\"1999\",\"Localauthority_Code\":\"W06000002\",\"Localauthority_ItemName_ENG\":\"Gwynedd\","
+      "\"Measure_Code\":\"Dens\",\"Measure_ItemName_ENG\":\"Population density\",\"Data\":4}"
+      "]}");
+
+    WHEN( "they are imported for 2019 only" ) {
+
+      Areas areas;
+      areas.populateFromWelshStatsJSON(stream, cols, BethYw::StringFilter(), BethYw::StringFilter(),
+        BethYw::YearFilter(2019, 2019));
+
+      THEN( "both areas are created with their names, but only the reading for 2019 is kept" ) {
+
+        REQUIRE( areas.size() == 2 );
+        REQUIRE( areas.getArea("W06000001").getName("eng") == "Isle of Anglesey" );
+        REQUIRE( areas.getArea("W06000001").getMeasure("dens").size() == 1 );
+        REQUIRE( areas.getArea("W06000001").getMeasure("dens").getValue(2019) == 2 );
+        REQUIRE( areas.getArea("W06000002").getName("eng") == "Gwynedd" );
+        REQUIRE( areas.getArea("W06000002").size() == 0 );
+
+      } // THEN
+
+    } // WHEN
+
+  } // GIVEN
+
+} // SCENARIO
@@ -0,0 +1,201 @@
+/*
+  +---------------------------------------+
+  | BETH YW? WELSH GOVERNMENT DATA PARSER |
+  +---------------------------------------+
+
+  AUTHOR: 979248
+
+  Catch2 test script — https://github.com/catchorg/Catch2
+  Catch2 is licensed under the BOOST license.
+ */
+
+#include "../lib_catch.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../lib_cxxopts.hpp"
+#include "../lib_cxxopts_argv.hpp"
+
+#include "../bethyw.h"
+#include "../filters.h"
+
+SCENARIO( "a YearFilter can be compiled from several ranges of years", "[YearFilter][ranges]" ) {
+
+  GIVEN( "the census years and every year from 2015" ) {
+
+    const BethYw::YearFilter filter(std::vector<BethYw::YearRange>{
+      BethYw::YearRange(1991, 1991),
+      BethYw::YearRange(2001, 2001),
+      BethYw::YearRange(2011, 2019),
+      BethYw::YearRange(2015, BethYw::YearFilter::OPEN)});
+
+    THEN( "only the years in one of the ranges are matched" ) {
+
+      REQUIRE_FALSE( filter.matchesAll() );
+      REQUIRE_FALSE( filter.contains(1990) );
+      REQUIRE( filter.contains(1991) );
+      REQUIRE_FALSE( filter.contains(1992) );
+      REQUIRE( filter.contains(2001) );
+      REQUIRE_FALSE( filter.contains(2010) );
+      REQUIRE( filter.contains(2011) );
+      REQUIRE( filter.contains(2019) );
+      REQUIRE( filter.contains(2020) );
+      REQUIRE( filter.contains(9999) );
+
+    } // THEN
+
+    THEN( "the lowest year is given, but the filter is open above" ) {
+
+      REQUIRE( filter.getFirst() == 1991 );
+      REQUIRE( filter.getLast() == 0 );
+      REQUIRE( filter.str() == "1991-1991,2001-2001,2011-2019,2015-" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "every year up to 1995 and the years 2000 to 2001" ) {
+
+    const BethYw::YearFilter filter(std::vector<BethYw::YearRange>{
+      BethYw::YearRange(0, 1995),
+      BethYw::YearRange(2000, 2001)});
+
+    THEN( "years below the bitmap are matched, but not those above it" ) {
+
+      REQUIRE( filter.contains(1) );
+      REQUIRE( filter.contains(1995) );
+      REQUIRE_FALSE( filter.contains(1996) );
+      REQUIRE( filter.contains(2001) );
+      REQUIRE_FALSE( filter.contains(2002) );
+      REQUIRE( filter.getFirst() == 0 );
+      REQUIRE( filter.getLast() == 2001 );
+      REQUIRE( filter.str() == "-1995,2000-2001" );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a single range and no ranges" ) {
+
+    const BethYw::YearFilter single(2010, 2015);
+    const BethYw::YearFilter none(std::vector<BethYw::YearRange>{});
+
+    THEN( "they are described as the years argument always has been" ) {
+
+      REQUIRE( single.str() == "2010-2015" );
+      REQUIRE( none.matchesAll() );
+      REQUIRE( none.str() == "0-0" );
+
+    } // THEN
+
+  } // GIVEN
+
+} // SCENARIO
+
+SCENARIO( "the years program argument can be parsed in to a YearFilter", "[args][years][YearFilter]" ) {
+
+  GIVEN( "a --years argument with a list of years and ranges ('1991,2001,2011-2019,2015-')" ) {
+
+    Argv argv({"test", "--years", "1991,2001,2011-2019,2015-"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "the filter matches the years in the list" ) {
+
+      auto years = BethYw::parseYearsFilterArg(args);
+      REQUIRE( years.contains(1991) );
+      REQUIRE( years.contains(2001) );
+      REQUIRE( years.contains(2012) );
+      REQUIRE( years.contains(2050) );
+      REQUIRE_FALSE( years.contains(1992) );
+      REQUIRE_FALSE( years.contains(2010) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a --years argument open below ('-2000')" ) {
+
+    Argv argv({"test", "--years", "-2000"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "the filter matches every year up to 2000" ) {
+
+      auto years = BethYw::parseYearsFilterArg(args);
+      REQUIRE( years.contains(1900) );
+      REQUIRE( years.contains(2000) );
+      REQUIRE_FALSE( years.contains(2001) );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "a --years argument that includes 0 ('2010,0')" ) {
+
+    Argv argv({"test", "--years", "2010,0"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "the filter matches every year" ) {
+
+      REQUIRE( BethYw::parseYearsFilterArg(args).matchesAll() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "no --years argument" ) {
+
+    Argv argv({"test"});
+    auto** actual_argv = argv.argv();
+    auto argc          = argv.argc();
+
+    auto cxxopts = BethYw::cxxoptsSetup();
+    auto args    = cxxopts.parse(argc, actual_argv);
+
+    THEN( "the filter matches every year" ) {
+
+      REQUIRE( BethYw::parseYearsFilterArg(args).matchesAll() );
+
+    } // THEN
+
+  } // GIVEN
+
+  GIVEN( "invalid --years arguments" ) {
+
+    const std::string exceptionMessage = "Invalid input for years argument";
+    const std::vector<std::string> values = {"2010,", ",2010", "-", "201-2015", "2010--2015", "2010-2015-", "20102015", "abc"};
+
+    for (auto& value : values) {
+
+      Argv argv({"test", "--years", value.c_str()});
+      auto** actual_argv = argv.argv();
+      auto argc          = argv.argc();
+
+      auto cxxopts = BethYw::cxxoptsSetup();
+      auto args    = cxxopts.parse(argc, actual_argv);
+
+      THEN( "an exception is thrown for '" + value + "'" ) {
+
+        REQUIRE_THROWS_AS(   BethYw::parseYearsFilterArg(args), std::invalid_argument );
+        REQUIRE_THROWS_WITH( BethYw::parseYearsFilterArg(args), exceptionMessage      );
+
+      } // THEN
+
+    }
+
+  } // GIVEN
+
+} // SCENARIO